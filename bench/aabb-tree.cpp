@@ -0,0 +1,107 @@
+// plugins::physics::AabbTree at 10k and 100k proxies: building by insertion, small moves that stay inside the fat
+// bounds, larger moves that force reinsertion, and 10k of each query.
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <entt/entt.hpp>
+
+#include "plugins/physics/aabb-tree.hpp"
+
+static constexpr size_t QUERY_COUNT = 10000;
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point begin) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+static void run(size_t proxyCount) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+  auto randomVec3 = [&]() { return glm::vec3(distribution(rng), distribution(rng), distribution(rng)); };
+
+  // Keeps the density the same at every size
+  float worldSize = std::cbrt(static_cast<float>(proxyCount)) * 4.0f;
+
+  std::vector<plugins::physics::Aabb> bounds(proxyCount);
+  for (auto& box : bounds) {
+    box = plugins::physics::Aabb::fromCenter(randomVec3() * worldSize, glm::vec3(0.2f + 0.3f * std::abs(distribution(rng))));
+  }
+
+  plugins::physics::AabbTree tree;
+  std::vector<int32_t> proxyIds(proxyCount);
+
+  auto begin = Clock::now();
+  for (size_t i = 0; i < proxyCount; ++i) {
+    proxyIds[i] = tree.createProxy(bounds[i], static_cast<entt::entity>(i));
+  }
+  double insertMs = elapsedMs(begin);
+
+  auto moveAll = [&](float distance) {
+    size_t reinsertedCount = 0;
+    for (size_t i = 0; i < proxyCount; ++i) {
+      glm::vec3 offset = randomVec3() * distance;
+      bounds[i].min += offset;
+      bounds[i].max += offset;
+      reinsertedCount += tree.moveProxy(proxyIds[i], bounds[i]);
+    }
+
+    return reinsertedCount;
+  };
+
+  begin = Clock::now();
+  size_t smallReinserted = moveAll(0.05f);
+  double smallMoveMs = elapsedMs(begin);
+
+  begin = Clock::now();
+  size_t largeReinserted = moveAll(1.0f);
+  double largeMoveMs = elapsedMs(begin);
+
+  std::vector<glm::vec3> origins(QUERY_COUNT);
+  std::vector<glm::vec3> directions(QUERY_COUNT);
+  for (size_t i = 0; i < QUERY_COUNT; ++i) {
+    origins[i] = randomVec3() * worldSize;
+    directions[i] = glm::normalize(randomVec3());
+  }
+
+  size_t hitCount = 0;
+
+  begin = Clock::now();
+  for (const auto& origin : origins) {
+    hitCount += tree.overlapBox(origin, glm::vec3(1.0f)).size();
+  }
+  double overlapBoxMs = elapsedMs(begin);
+
+  begin = Clock::now();
+  for (size_t i = 0; i < QUERY_COUNT; ++i) {
+    hitCount += tree.raycast(origins[i], directions[i], 10.0f).has_value();
+  }
+  double raycastMs = elapsedMs(begin);
+
+  begin = Clock::now();
+  for (const auto& origin : origins) {
+    hitCount += tree.overlapSphere(origin, 1.0f).size();
+  }
+  double overlapSphereMs = elapsedMs(begin);
+
+  std::println("{} proxies, height {}, {} hits", proxyCount, tree.getHeight(), hitCount);
+  std::println("  insert          {:8.2f} ms", insertMs);
+  std::println("  small moves     {:8.2f} ms ({} reinserted)", smallMoveMs, smallReinserted);
+  std::println("  large moves     {:8.2f} ms ({} reinserted)", largeMoveMs, largeReinserted);
+  std::println("  overlapBox      {:8.2f} ms", overlapBoxMs);
+  std::println("  raycast         {:8.2f} ms", raycastMs);
+  std::println("  overlapSphere   {:8.2f} ms", overlapSphereMs);
+}
+
+int main() {
+  for (size_t proxyCount : {10000, 100000}) {
+    run(proxyCount);
+  }
+
+  return EXIT_SUCCESS;
+}
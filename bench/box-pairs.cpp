@@ -0,0 +1,84 @@
+// Narrowphase box tests on 1M random pairs: testBoxPairs with whichever kernel the CPU gets, against the scalar
+// reference. Every 97th pair is an exact tie between axes, where the kernels have to pick the same axis the scalar
+// code does.
+//
+// Results have to match the scalar reference bit for bit, so any mismatch is reported.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <glm/glm.hpp>
+
+#include "plugins/physics/narrowphase.hpp"
+
+static constexpr size_t PAIR_COUNT = 1000000;
+static constexpr size_t TIE_STRIDE = 97;
+static constexpr int RUN_COUNT = 10;
+
+// Best of RUN_COUNT runs over the whole batch, in milliseconds
+template <typename Fn>
+static double timeBest(plugins::physics::BoxPairBatch& batch, Fn&& testPairs) {
+  double bestMs = 1e9;
+  for (int run = 0; run < RUN_COUNT; ++run) {
+    auto begin = std::chrono::steady_clock::now();
+    testPairs(batch, 0, batch.size());
+    bestMs = std::min(bestMs, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+  }
+
+  return bestMs;
+}
+
+static bool isSameBits(float a, float b) {
+  return std::bit_cast<uint32_t>(a) == std::bit_cast<uint32_t>(b);
+}
+
+int main() {
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> positionDistribution(-2.0f, 2.0f);
+  std::uniform_real_distribution<float> halfExtentDistribution(0.1f, 1.0f);
+  auto randomPosition = [&]() {
+    return glm::vec3(positionDistribution(rng), positionDistribution(rng), positionDistribution(rng));
+  };
+  auto randomHalfExtents = [&]() {
+    return glm::vec3(halfExtentDistribution(rng), halfExtentDistribution(rng), halfExtentDistribution(rng));
+  };
+
+  plugins::physics::BoxPairBatch batch;
+  batch.resize(PAIR_COUNT);
+  for (size_t i = 0; i < PAIR_COUNT; ++i) {
+    batch.set(i, randomPosition(), randomHalfExtents(), randomPosition(), randomHalfExtents());
+  }
+  for (size_t i = 0; i < PAIR_COUNT; i += TIE_STRIDE) {
+    batch.set(i, glm::vec3(0.5f, 0.5f, -0.5f), glm::vec3(1.0f), glm::vec3(0.0f), glm::vec3(1.0f));
+  }
+
+  double scalarMs = timeBest(batch, plugins::physics::testBoxPairsScalar);
+  plugins::physics::BoxPairBatch reference = batch;
+  double kernelMs = timeBest(batch, plugins::physics::testBoxPairs);
+
+  size_t collidingCount = 0;
+  size_t mismatchCount = 0;
+  for (size_t i = 0; i < PAIR_COUNT; ++i) {
+    collidingCount += reference.isColliding[i];
+
+    bool isMatch = reference.isColliding[i] == batch.isColliding[i] &&
+                   isSameBits(reference.penetrationX[i], batch.penetrationX[i]) &&
+                   isSameBits(reference.penetrationY[i], batch.penetrationY[i]) &&
+                   isSameBits(reference.penetrationZ[i], batch.penetrationZ[i]);
+    mismatchCount += !isMatch;
+  }
+
+  auto nsPerPair = [](double ms) { return ms * 1e6 / static_cast<double>(PAIR_COUNT); };
+
+  std::println("{} pairs, {} colliding, best of {} runs", PAIR_COUNT, collidingCount, RUN_COUNT);
+  std::println("scalar: {:.2f} ms ({:.2f} ns/pair)", scalarMs, nsPerPair(scalarMs));
+  std::println("{}: {:.2f} ms ({:.2f} ns/pair, {:.1f}x)", plugins::physics::getNarrowphaseKernelName(), kernelMs,
+               nsPerPair(kernelMs), scalarMs / kernelMs);
+  std::println("{} mismatches against scalar", mismatchCount);
+
+  return mismatchCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
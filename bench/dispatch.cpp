@@ -0,0 +1,194 @@
+// Cost of dispatching trivial systems, resource lookups included.
+//
+// 1000 systems read two resources and write a third, dispatched three ways:
+// - map lookup: every call looks each resource up in an unordered_map<type_index, std::any>, like Game did before
+//   resources moved into slots
+// - cached slots: pointers resolved from the slot table on the first call and kept in the closure, like
+//   Game::addSystemInternal does now
+// - Game: the real Update schedule, which adds the scheduler graph and a profiler scope per system on top
+//
+// The first two run their closures in a plain loop without any profiling, so the lookup is all that differs. Run with
+// QUN_WORKER_THREADS=0 to keep the Game run on the sequential path too.
+
+#include <any>
+#include <chrono>
+#include <cstdlib>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <print>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+#include "game.hpp"
+
+static constexpr size_t SYSTEM_COUNT = 1000;
+static constexpr uint64_t FRAME_COUNT = 2000;
+
+struct Counter {
+  int value = 0;
+};
+
+struct Increment {
+  int value = 1;
+};
+
+struct Scale {
+  float value = 2.0f;
+};
+
+using SystemFn = std::function<std::expected<void, std::string>()>;
+
+static void increment(const Increment& increment, const Scale&, std::shared_ptr<Counter>& counter) {
+  counter->value += increment.value;
+}
+
+// Resource storage as Game had it before slots
+class MapResources {
+public:
+  template <typename T> void add(T resource) {
+    resources[std::type_index(typeid(T))] = std::make_any<T>(std::move(resource));
+  }
+
+  template <typename T> T& get() {
+    auto it = resources.find(std::type_index(typeid(T)));
+    if (it == resources.end()) {
+      throw std::runtime_error("Resource type not registered: " + std::string(typeid(T).name()));
+    }
+
+    return std::any_cast<T&>(it->second);
+  }
+
+private:
+  std::unordered_map<std::type_index, std::any> resources;
+};
+
+// Resource storage as Game has it now, indexed by scheduler::ResourceId
+class SlotResources {
+public:
+  template <typename T> void add(T resource) {
+    auto id = scheduler::resourceId<T>();
+    if (id >= slots.size()) {
+      slots.resize(id + 1);
+    }
+
+    slots[id] = std::make_shared<T>(std::move(resource));
+  }
+
+  template <typename T> T& get() {
+    auto id = scheduler::resourceId<T>();
+    if (id >= slots.size() || !slots[id]) {
+      throw std::runtime_error("Resource type not registered: " + std::string(typeid(T).name()));
+    }
+
+    return *static_cast<T*>(slots[id].get());
+  }
+
+private:
+  std::vector<std::shared_ptr<void>> slots;
+};
+
+// Nanoseconds per system call, over every frame
+static double runSystems(std::vector<SystemFn>& systems) {
+  auto begin = std::chrono::steady_clock::now();
+  for (uint64_t frame = 0; frame < FRAME_COUNT; ++frame) {
+    for (auto& system : systems) {
+      if (auto result = system(); !result.has_value()) {
+        throw std::runtime_error(result.error());
+      }
+    }
+  }
+
+  double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+  return elapsedNs / static_cast<double>(FRAME_COUNT * systems.size());
+}
+
+static double benchMapLookup() {
+  MapResources resources;
+  resources.add(Increment{});
+  resources.add(Scale{});
+  resources.add(std::make_shared<Counter>());
+
+  std::vector<SystemFn> systems;
+  for (size_t i = 0; i < SYSTEM_COUNT; ++i) {
+    systems.push_back([&resources]() -> std::expected<void, std::string> {
+      increment(resources.get<Increment>(), resources.get<Scale>(), resources.get<std::shared_ptr<Counter>>());
+      return {};
+    });
+  }
+
+  return runSystems(systems);
+}
+
+static double benchCachedSlots() {
+  SlotResources resources;
+  resources.add(Increment{});
+  resources.add(Scale{});
+  resources.add(std::make_shared<Counter>());
+
+  using CachedResources = std::tuple<Increment*, Scale*, std::shared_ptr<Counter>*>;
+
+  std::vector<SystemFn> systems;
+  for (size_t i = 0; i < SYSTEM_COUNT; ++i) {
+    systems.push_back([&resources, cached = CachedResources{},
+                       isResolved = false]() mutable -> std::expected<void, std::string> {
+      if (!isResolved) {
+        cached = {&resources.get<Increment>(), &resources.get<Scale>(), &resources.get<std::shared_ptr<Counter>>()};
+        isResolved = true;
+      }
+
+      auto [incrementResource, scale, counter] = cached;
+      increment(*incrementResource, *scale, *counter);
+      return {};
+    });
+  }
+
+  return runSystems(systems);
+}
+
+static const scheduler::ProfileScope* findScope(const scheduler::Profiler& profiler, std::string_view name) {
+  for (size_t i = 0; i < profiler.getScopeCount(); ++i) {
+    if (profiler.getScope(i).name == name) {
+      return &profiler.getScope(i);
+    }
+  }
+
+  return nullptr;
+}
+
+int main() {
+  double mapNs = benchMapLookup();
+  double slotNs = benchCachedSlots();
+
+  Game game;
+  game.addResource(Increment{});
+  game.addResource(Scale{});
+  game.addResource(std::make_shared<Counter>());
+
+  for (size_t i = 0; i < SYSTEM_COUNT; ++i) {
+    game.addSystem(Schedule::Update, increment);
+  }
+
+  game.setFrameLimit(FRAME_COUNT);
+  if (auto result = game.start(); !result.has_value()) {
+    std::println(stderr, "{}", result.error());
+    return EXIT_FAILURE;
+  }
+
+  // Rolling stats only keep the most recent frames, so this is steady state
+  const auto* update = findScope(game.getProfiler(), "Update");
+  float gameNs = update->stats.getAverage() * 1e6f / static_cast<float>(SYSTEM_COUNT);
+
+  std::println("{} systems, {} frames, {} workers", SYSTEM_COUNT, FRAME_COUNT, game.getThreadPool()->getWorkerCount());
+  std::println("map lookup:    {:6.1f} ns per system", mapNs);
+  std::println("cached slots:  {:6.1f} ns per system ({:.1f}x)", slotNs, mapNs / slotNs);
+  std::println("Game (Update): {:6.1f} ns per system, graph and profiling included", gameNs);
+
+  return EXIT_SUCCESS;
+}
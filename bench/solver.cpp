@@ -0,0 +1,115 @@
+// Contact colouring and the velocity solver on 60k contacts between 20k bodies, one in ten against static geometry,
+// from no worker threads up to the default pool size (or 3, whichever is more).
+//
+// Every run starts from the same state, so the velocity hash printed per worker count has to match across all of them.
+// Colouring is always serial, only the solve fans out over the pool. Set QUN_WORKER_THREADS to scan further than the
+// default.
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "plugins/physics/solver.hpp"
+
+static constexpr size_t BODY_COUNT = 20000;
+static constexpr size_t CONTACT_COUNT = 60000;
+static constexpr int RUN_COUNT = 5;
+
+// Marks the second side of a contact as immovable
+static constexpr size_t STATIC_BODY = SIZE_MAX;
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point begin) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+// FNV-1a over the velocities' bits
+static uint64_t hashVelocities(const std::vector<glm::vec3>& velocities) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const auto& velocity : velocities) {
+    for (int axis = 0; axis < 3; ++axis) {
+      hash ^= std::bit_cast<uint32_t>(velocity[axis]);
+      hash *= 1099511628211ull;
+    }
+  }
+
+  return hash;
+}
+
+int main() {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+
+  std::vector<glm::vec3> initialVelocities(BODY_COUNT);
+  for (auto& velocity : initialVelocities) {
+    velocity = glm::vec3(distribution(rng), distribution(rng), distribution(rng));
+  }
+
+  std::vector<plugins::physics::Contact> initialContacts(CONTACT_COUNT);
+  std::vector<std::pair<size_t, size_t>> bodyIdxs(CONTACT_COUNT);
+  for (size_t i = 0; i < CONTACT_COUNT; ++i) {
+    size_t body1 = rng() % BODY_COUNT;
+    size_t body2 = rng() % BODY_COUNT;
+    if (body1 == body2) {
+      body2 = (body2 + 1) % BODY_COUNT;
+    }
+    bodyIdxs[i] = {body1, rng() % 10 == 0 ? STATIC_BODY : body2};
+
+    auto& contact = initialContacts[i];
+    contact.normal = glm::vec3(0.0f);
+    contact.normal[static_cast<int>(rng() % 3)] = rng() % 2 ? 1.0f : -1.0f;
+    contact.depth = 0.01f;
+    contact.normalImpulse = static_cast<float>(rng() % 3) * 0.1f;
+  }
+
+  std::println("{} contacts between {} bodies, best of {} runs", CONTACT_COUNT, BODY_COUNT, RUN_COUNT);
+
+  // At least a few workers even on small machines, so the hashes still get compared across thread counts
+  size_t maxWorkerCount = std::max<size_t>(util::ThreadPool::defaultWorkerCount(), 3);
+
+  for (size_t workerCount = 0; workerCount <= maxWorkerCount; ++workerCount) {
+    util::ThreadPool pool(workerCount);
+
+    double bestColorMs = 1e9;
+    double bestSolveMs = 1e9;
+    size_t batchCount = 0;
+    uint64_t hash = 0;
+
+    for (int run = 0; run < RUN_COUNT; ++run) {
+      auto velocities = initialVelocities;
+      auto contacts = initialContacts;
+
+      std::vector<plugins::physics::SolverContact> solverContacts;
+      solverContacts.reserve(CONTACT_COUNT);
+      for (size_t i = 0; i < CONTACT_COUNT; ++i) {
+        auto [body1, body2] = bodyIdxs[i];
+        solverContacts.push_back({&contacts[i], &velocities[body1], body2 == STATIC_BODY ? nullptr : &velocities[body2]});
+      }
+
+      auto begin = Clock::now();
+      plugins::physics::ContactBatches batches;
+      plugins::physics::colorContacts(solverContacts, batches);
+      bestColorMs = std::min(bestColorMs, elapsedMs(begin));
+
+      begin = Clock::now();
+      plugins::physics::solveVelocities(solverContacts, batches, pool);
+      bestSolveMs = std::min(bestSolveMs, elapsedMs(begin));
+
+      batchCount = batches.getBatchCount();
+      hash = hashVelocities(velocities);
+    }
+
+    std::println("{} workers: colour {:.2f} ms, solve {:.2f} ms, {} batches, hash {:016x}", workerCount, bestColorMs,
+                 bestSolveMs, batchCount, hash);
+  }
+
+  return EXIT_SUCCESS;
+}
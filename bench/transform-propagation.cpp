@@ -0,0 +1,149 @@
+// Transform propagation over a 10k node hierarchy: 100 roots, each with a 99 node subtree of branching factor 3. Every
+// node's Position is replaced once per frame, like the physics step does.
+//
+// The batched pass is the real transform::propagate system. It's compared against recomputing each changed node and
+// its whole subtree straight away, which is what the Position signals used to do.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <print>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <entt/entt.hpp>
+
+#include "game.hpp"
+#include "components/parent.hpp"
+#include "components/transform.hpp"
+
+static constexpr size_t ROOT_COUNT = 100;
+static constexpr size_t NODES_PER_ROOT = 100;
+static constexpr size_t BRANCHING = 3;
+static constexpr uint64_t FRAME_COUNT = 300;
+
+static const scheduler::ProfileScope* findScope(const scheduler::Profiler& profiler, std::string_view name) {
+  for (size_t i = 0; i < profiler.getScopeCount(); ++i) {
+    if (profiler.getScope(i).name == name) {
+      return &profiler.getScope(i);
+    }
+  }
+
+  return nullptr;
+}
+
+static void buildHierarchy(entt::registry& registry, std::vector<entt::entity>& nodes) {
+  for (size_t root = 0; root < ROOT_COUNT; ++root) {
+    size_t base = nodes.size();
+
+    for (size_t i = 0; i < NODES_PER_ROOT; ++i) {
+      entt::entity entity = registry.create();
+      registry.emplace<components::Position>(entity, glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+      registry.emplace<components::Rotation>(entity, glm::angleAxis(0.1f, glm::vec3(0.0f, 0.0f, 1.0f)));
+      registry.emplace<components::Scale>(entity, glm::vec3(1.0f));
+      nodes.push_back(entity);
+
+      if (i == 0) {
+        continue;
+      }
+
+      entt::entity parent = nodes[base + (i - 1) / BRANCHING];
+      registry.emplace<components::Child>(entity, parent);
+      registry.get_or_emplace<components::Parent>(parent).children.push_back(entity);
+    }
+  }
+}
+
+// Local transform as three full matrices and two products, then recursion into every child
+static void recomputeSubtree(entt::registry& registry, entt::entity entity, const glm::mat4& parentTransform) {
+  glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), registry.get<components::Position>(entity).value) *
+                             glm::mat4_cast(registry.get<components::Rotation>(entity).value) *
+                             glm::scale(glm::mat4(1.0f), registry.get<components::Scale>(entity).value);
+
+  glm::mat4 globalTransform = parentTransform * localTransform;
+  registry.get<components::GlobalTransform>(entity).value = globalTransform;
+
+  if (auto* parent = registry.try_get<components::Parent>(entity)) {
+    for (entt::entity child : parent->children) {
+      recomputeSubtree(registry, child, globalTransform);
+    }
+  }
+}
+
+int main() {
+  std::vector<entt::entity> nodes;
+
+  Game game;
+  game.addPlugin(plugins::EnTT{});
+  game.addPlugin(plugins::Transform{});
+  game.addPlugin(plugins::Time{.syntheticDeltaTime = 1.0f / 60.0f});
+
+  game.addSystem(Schedule::Startup, [&nodes](std::shared_ptr<entt::registry>& registry) {
+    buildHierarchy(*registry, nodes);
+  });
+
+  game.addSystem(Schedule::Update, "bench::move", [&nodes](std::shared_ptr<entt::registry>& registry) {
+    for (entt::entity entity : nodes) {
+      glm::vec3 position = registry->get<components::Position>(entity).value;
+      registry->replace<components::Position>(entity, position + glm::vec3(0.01f));
+    }
+  });
+
+  game.setFrameLimit(FRAME_COUNT);
+  if (auto result = game.start(); !result.has_value()) {
+    std::println(stderr, "{}", result.error());
+    return EXIT_FAILURE;
+  }
+
+  auto& registry = **game.findResource<std::shared_ptr<entt::registry>>();
+  float batchedMs = findScope(game.getProfiler(), "transform::propagate")->stats.getAverage();
+  float moveMs = findScope(game.getProfiler(), "bench::move")->stats.getAverage();
+
+  // Both have to agree on where everything ends up
+  std::vector<glm::mat4> batchedTransforms;
+  for (entt::entity entity : nodes) {
+    batchedTransforms.push_back(registry.get<components::GlobalTransform>(entity).value);
+  }
+
+  for (entt::entity entity : nodes) {
+    if (!registry.all_of<components::Child>(entity)) {
+      recomputeSubtree(registry, entity, glm::mat4(1.0f));
+    }
+  }
+
+  float maxError = 0.0f;
+  for (size_t i = 0; i < nodes.size(); ++i) {
+    const glm::mat4& recursive = registry.get<components::GlobalTransform>(nodes[i]).value;
+    for (int column = 0; column < 4; ++column) {
+      for (int row = 0; row < 4; ++row) {
+        maxError = std::max(maxError, std::abs(batchedTransforms[i][column][row] - recursive[column][row]));
+      }
+    }
+  }
+
+  // Written in place so no signals fire, leaving only the recursive work itself
+  auto begin = std::chrono::steady_clock::now();
+  for (uint64_t frame = 0; frame < FRAME_COUNT; ++frame) {
+    for (entt::entity entity : nodes) {
+      registry.get<components::Position>(entity).value += glm::vec3(0.01f);
+
+      auto* child = registry.try_get<components::Child>(entity);
+      glm::mat4 parentTransform = child ? registry.get<components::GlobalTransform>(child->parent).value : glm::mat4(1.0f);
+      recomputeSubtree(registry, entity, parentTransform);
+    }
+  }
+  double recursiveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count() /
+                       static_cast<double>(FRAME_COUNT);
+
+  std::println("{} nodes, {} frames", nodes.size(), FRAME_COUNT);
+  std::println("recursive: {:.3f} ms/frame", recursiveMs);
+  std::println("batched:   {:.3f} ms/frame (transform::propagate)", batchedMs);
+  std::println("  plus the Position writes flagging them: {:.3f} ms/frame", batchedMs + moveMs);
+  std::println("max difference {}", maxError);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+// Local transforms of 100k flat entities: util::trs::compose against translate * mat4_cast * scale, the way
+// computeLocalTransform built them before.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <print>
+#include <random>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "util/trs.hpp"
+
+static constexpr size_t ENTITY_COUNT = 100000;
+static constexpr int RUN_COUNT = 50;
+
+using Clock = std::chrono::steady_clock;
+
+static double elapsedMs(Clock::time_point begin) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+}
+
+int main() {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+  std::vector<glm::vec3> positions(ENTITY_COUNT);
+  std::vector<glm::quat> rotations(ENTITY_COUNT);
+  std::vector<glm::vec3> scales(ENTITY_COUNT);
+
+  for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+    positions[i] = glm::vec3(distribution(rng), distribution(rng), distribution(rng)) * 10.0f;
+    rotations[i] = glm::normalize(glm::quat(distribution(rng), distribution(rng), distribution(rng), distribution(rng)));
+    scales[i] = glm::vec3(1.0f) + glm::vec3(distribution(rng), distribution(rng), distribution(rng)) * 0.5f;
+  }
+
+  std::vector<glm::mat4> reference(ENTITY_COUNT);
+  std::vector<glm::mat4> composed(ENTITY_COUNT);
+  util::trs::Batch batch;
+
+  auto begin = Clock::now();
+  for (int run = 0; run < RUN_COUNT; ++run) {
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+      reference[i] = glm::translate(glm::mat4(1.0f), positions[i]) * glm::mat4_cast(rotations[i]) *
+                     glm::scale(glm::mat4(1.0f), scales[i]);
+    }
+  }
+  double referenceMs = elapsedMs(begin) / RUN_COUNT;
+
+  double gatherMs = 0.0;
+  double composeMs = 0.0;
+  for (int run = 0; run < RUN_COUNT; ++run) {
+    begin = Clock::now();
+    batch.resize(ENTITY_COUNT);
+    for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+      batch.set(i, positions[i], rotations[i], scales[i]);
+    }
+    gatherMs += elapsedMs(begin);
+
+    begin = Clock::now();
+    util::trs::compose(batch, composed.data());
+    composeMs += elapsedMs(begin);
+  }
+  gatherMs /= RUN_COUNT;
+  composeMs /= RUN_COUNT;
+
+  float maxError = 0.0f;
+  for (size_t i = 0; i < ENTITY_COUNT; ++i) {
+    for (int column = 0; column < 4; ++column) {
+      for (int row = 0; row < 4; ++row) {
+        maxError = std::max(maxError, std::abs(reference[i][column][row] - composed[i][column][row]));
+      }
+    }
+  }
+
+  std::println("{} entities, average of {} runs, {} kernel", ENTITY_COUNT, RUN_COUNT, util::trs::getKernelName());
+  std::println("translate * rotate * scale: {:.3f} ms", referenceMs);
+  std::println("util::trs::compose:         {:.3f} ms ({:.1f}x)", composeMs, referenceMs / composeMs);
+  std::println("  plus gathering into SoA:  {:.3f} ms ({:.1f}x)", composeMs + gatherMs,
+               referenceMs / (composeMs + gatherMs));
+  std::println("max difference {}", maxError);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,35 @@
+#version 460 core
+
+// Depth pre-pass. Positions are worked out exactly as main.vert does, so the colour pass can test GL_EQUAL against
+// what this wrote.
+
+struct Draw {
+    uint firstInstance;
+    uint materialIdx;
+};
+
+layout(location = 0) in vec3 vertPos;
+
+layout(std140, binding = 1) uniform Camera {
+    mat4x4 projMatrix;
+    mat4x4 viewMatrix;
+    vec3 cameraPos;
+};
+
+layout(std430, binding = 1) readonly buffer DrawTable {
+    Draw draws[];
+};
+
+layout(std430, binding = 2) readonly buffer InstanceTable {
+    mat4x4 modelMatrices[];
+};
+
+invariant gl_Position;
+
+void main() {
+    Draw draw = draws[gl_BaseInstance];
+    mat4x4 modelMatrix = modelMatrices[draw.firstInstance + gl_InstanceID];
+
+    vec4 modelPos = modelMatrix * vec4(vertPos, 1.0);
+    gl_Position = projMatrix * viewMatrix * modelPos;
+}
@@ -1,9 +1,10 @@
-#version 450 core
+#version 460 core
 
 struct Light {
     vec3 position;
-    vec3 color;
     float radius;
+    vec3 color;
+    float _padding;
 };
 
 struct Texture {
@@ -17,37 +18,57 @@ struct Texture {
     float uvRotation;
 };
 
+struct Material {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    float dissolve;
+    vec3 specular;
+    float emissiveStrength;
+    vec3 emissive;
+    float _padding;
+    Texture diffuseTexture;
+    Texture normalTexture;
+    Texture emissiveTexture;
+};
+
 in vec3 fragPos;
 in vec3 fragNormal;
 in vec2 fragUV;
 in mat3 fragTBN;
+flat in uint fragMaterialIdx;
 
-layout(location = 0) uniform mat4x4 projMatrix;
-layout(location = 1) uniform mat4x4 viewMatrix;
-layout(location = 2) uniform mat4x4 modelMatrix;
+layout(std140, binding = 1) uniform Camera {
+    mat4x4 projMatrix;
+    mat4x4 viewMatrix;
+    vec3 cameraPos;
+};
 
 layout(location = 3) uniform sampler2DArray textureList;
-layout(location = 4) uniform vec3 cameraPos;
 
-#define MAX_LIGHTS 40
+// Froxels over the view frustum: tiles across the viewport, sliced exponentially along view depth
+layout(std140, binding = 0) uniform ClusterGrid {
+    vec4 viewport;
+    uvec3 gridSize;
+    float sliceScale;
+    float sliceBias;
+};
 
-layout(std140, binding = 0) uniform LightsArray {
-    uint lightCount;
-    Light lights[MAX_LIGHTS];
+layout(std140, binding = 0) readonly buffer MaterialTable {
+    Material materials[];
 };
 
-layout(std140, binding = 1) uniform Material3D {
-    vec3 materialAmbient;
-    float materialShininess;
-    vec3 materialDiffuse;
-    float materialDissolve;
-    vec3 materialSpecular;
-    float emissiveStrength;
-    vec3 materialEmissive;
-    float _padding;
-    Texture diffuseTexture;
-    Texture normalTexture;
-    Texture emissiveTexture;
+layout(std430, binding = 6) readonly buffer LightTable {
+    Light lights[];
+};
+
+// First light and light count of each cluster in the index list
+layout(std430, binding = 7) readonly buffer ClusterLights {
+    uvec2 clusterLights[];
+};
+
+layout(std430, binding = 8) readonly buffer LightIndexList {
+    uint lightIndices[];
 };
 
 out vec4 outColor;
@@ -70,19 +91,31 @@ vec2 transformUV(vec2 uv, Texture tex) {
     return transformedUV;
 }
 
+uint getClusterIdx() {
+    uvec2 tile = uvec2((gl_FragCoord.xy - viewport.xy) / viewport.zw * vec2(gridSize.xy));
+    tile = min(tile, gridSize.xy - 1u);
+
+    float viewDepth = -(viewMatrix * vec4(fragPos, 1.0)).z;
+    uint slice = uint(clamp(log(viewDepth) * sliceScale + sliceBias, 0.0, float(gridSize.z - 1u)));
+
+    return tile.x + gridSize.x * (tile.y + gridSize.y * slice);
+}
+
 void main() {
+    Material material = materials[fragMaterialIdx];
+
     vec3 fragToCameraDir = normalize(cameraPos - fragPos);
 
     vec3 baseColor = vec3(1.0);
-    if (diffuseTexture.index >= 0) {
-        vec2 diffuseUV = transformUV(fragUV, diffuseTexture);
-        baseColor = texture(textureList, vec3(diffuseUV, float(diffuseTexture.index))).rgb;
+    if (material.diffuseTexture.index >= 0) {
+        vec2 diffuseUV = transformUV(fragUV, material.diffuseTexture);
+        baseColor = texture(textureList, vec3(diffuseUV, float(material.diffuseTexture.index))).rgb;
     }
 
     vec3 normal = fragNormal;
-    if (normalTexture.index >= 0) {
-        vec2 normalUV = transformUV(fragUV, normalTexture);
-        vec3 normalMap = texture(textureList, vec3(normalUV, float(normalTexture.index))).rgb;
+    if (material.normalTexture.index >= 0) {
+        vec2 normalUV = transformUV(fragUV, material.normalTexture);
+        vec3 normalMap = texture(textureList, vec3(normalUV, float(material.normalTexture.index))).rgb;
         normalMap = normalize(normalMap * 2.0 - 1.0); // [0,1] -> [-1,1]
         normal = normalize(fragTBN * normalMap); // tangent space to world space
     }
@@ -90,8 +123,19 @@ void main() {
     vec3 diffuse = vec3(0.0);
     vec3 specular = vec3(0.0);
 
-    for (uint i = 0; i < lightCount; i++) {
-        vec3 lightToFrag = fragPos - lights[i].position;
+    uvec2 cluster = clusterLights[getClusterIdx()];
+    for (uint i = cluster.x; i < cluster.x + cluster.y; i++) {
+        Light light = lights[lightIndices[i]];
+
+        vec3 lightToFrag = fragPos - light.position;
+
+        // Clusters are coarser than lights, so most of a cluster's lights don't reach a given fragment
+        float distSquared = dot(lightToFrag, lightToFrag);
+        float radiusSquared = light.radius * light.radius;
+        if (distSquared >= radiusSquared) {
+            continue;
+        }
+
         vec3 lightToFragDir = normalize(lightToFrag);
         vec3 fragToLightDir = -lightToFragDir;
 
@@ -102,28 +146,32 @@ void main() {
         float spec = 0.0;
         if (diff > 0.0) {
             vec3 reflectDir = reflect(lightToFragDir, normal);
-            spec = pow(max(dot(fragToCameraDir, reflectDir), 0.0), materialShininess);
+            spec = pow(max(dot(fragToCameraDir, reflectDir), 0.0), material.shininess);
         }
 
         // Avoid extreme light at very close distances
         float distToLight = length(lightToFrag);
         float distAttenuation = 1.0 / (1.0 + 0.09 * distToLight + 0.032 * distToLight * distToLight);
 
-        diffuse += diff * lights[i].color * distAttenuation;
-        specular += spec * lights[i].color * distAttenuation;
+        // Fades out to nothing at the radius, so lights can be left out of clusters beyond it
+        float radiusFalloff = 1.0 - (distSquared * distSquared) / (radiusSquared * radiusSquared);
+        distAttenuation *= radiusFalloff * radiusFalloff;
+
+        diffuse += diff * light.color * distAttenuation;
+        specular += spec * light.color * distAttenuation;
     }
 
-    vec3 emissive = materialEmissive * emissiveStrength;
-    if (emissiveTexture.index >= 0) {
-        vec2 emissiveUV = transformUV(fragUV, emissiveTexture);
-        vec3 emissiveTextureSample = texture(textureList, vec3(emissiveUV, float(emissiveTexture.index))).rgb;
+    vec3 emissive = material.emissive * material.emissiveStrength;
+    if (material.emissiveTexture.index >= 0) {
+        vec2 emissiveUV = transformUV(fragUV, material.emissiveTexture);
+        vec3 emissiveTextureSample = texture(textureList, vec3(emissiveUV, float(material.emissiveTexture.index))).rgb;
         emissive *= emissiveTextureSample;
     }
 
-    vec3 ambientPart = materialAmbient * baseColor;
-    vec3 diffusePart = materialDiffuse * baseColor * diffuse;
-    vec3 specularPart = materialSpecular * specular;
+    vec3 ambientPart = material.ambient * baseColor;
+    vec3 diffusePart = material.diffuse * baseColor * diffuse;
+    vec3 specularPart = material.specular * specular;
 
     vec3 resultColor = ambientPart + diffusePart + specularPart + emissive;
-    outColor = vec4(resultColor, materialDissolve);
+    outColor = vec4(resultColor, material.dissolve);
 }
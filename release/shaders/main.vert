@@ -1,4 +1,4 @@
-#version 450 core
+#version 460 core
 
 struct Texture {
     vec2 uvScale;
@@ -11,45 +11,71 @@ struct Texture {
     float uvRotation;
 };
 
+struct Material {
+    vec3 ambient;
+    float shininess;
+    vec3 diffuse;
+    float dissolve;
+    vec3 specular;
+    float emissiveStrength;
+    vec3 emissive;
+    float _padding;
+    Texture diffuseTexture;
+    Texture normalTexture;
+    Texture emissiveTexture;
+};
+
+struct Draw {
+    uint firstInstance;
+    uint materialIdx;
+};
+
 layout(location = 0) in vec3 vertPos;
 layout(location = 1) in vec3 vertNormal;
 layout(location = 2) in vec2 vertUV;
 layout(location = 3) in vec3 vertTangent;
 
-layout(location = 0) uniform mat4x4 projMatrix;
-layout(location = 1) uniform mat4x4 viewMatrix;
-layout(location = 2) uniform mat4x4 modelMatrix;
+layout(std140, binding = 1) uniform Camera {
+    mat4x4 projMatrix;
+    mat4x4 viewMatrix;
+    vec3 cameraPos;
+};
 
 layout(location = 3) uniform sampler2DArray textureList;
-layout(location = 4) uniform vec3 cameraPos;
-
-layout(std140, binding = 1) uniform Material3D {
-    vec3 materialAmbient;
-    float materialShininess;
-    vec3 materialDiffuse;
-    float materialDissolve;
-    vec3 materialSpecular;
-    float emissiveStrength;
-    vec3 materialEmissive;
-    float _padding;
-    Texture diffuseTexture;
-    Texture normalTexture;
-    Texture emissiveTexture;
+
+layout(std140, binding = 0) readonly buffer MaterialTable {
+    Material materials[];
 };
 
+// Indexed by gl_BaseInstance, which the renderer sets per draw command
+layout(std430, binding = 1) readonly buffer DrawTable {
+    Draw draws[];
+};
+
+layout(std430, binding = 2) readonly buffer InstanceTable {
+    mat4x4 modelMatrices[];
+};
+
+// Matches depth.vert bit for bit, for the colour pass after a depth pre-pass
+invariant gl_Position;
+
 out vec3 fragPos;
 out vec3 fragNormal;
 out vec2 fragUV;
 out mat3 fragTBN;
+flat out uint fragMaterialIdx;
 
 void main() {
+    Draw draw = draws[gl_BaseInstance];
+    mat4x4 modelMatrix = modelMatrices[draw.firstInstance + gl_InstanceID];
+
     vec4 modelPos = modelMatrix * vec4(vertPos, 1.0);
 
     mat3 normalMatrix = transpose(inverse(mat3(modelMatrix)));
     vec3 transformedNormal = normalize(normalMatrix * vertNormal);
 
     // Only calculate TBN if normal map present
-    if (normalTexture.index >= 0) {
+    if (materials[draw.materialIdx].normalTexture.index >= 0) {
         vec3 transformedTangent = normalize(normalMatrix * vertTangent);
         vec3 transformedBitangent = normalize(cross(transformedNormal, transformedTangent));
 
@@ -64,6 +90,7 @@ void main() {
     fragNormal = transformedNormal;
     fragPos = modelPos.xyz;
     fragUV = vertUV;
+    fragMaterialIdx = draw.materialIdx;
 
     gl_Position = worldPos;
 }
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <memory>
+
 #include <glm/glm.hpp>
 
+namespace plugins::physics {
+  class MeshBvh;
+};
+
 namespace components {
   struct Velocity {
     glm::vec3 value;
@@ -23,4 +29,14 @@ namespace components {
   struct BoxCollider {
     glm::vec3 halfExtents;
   };
+
+  // Static collider against a triangle mesh, eg. level geometry. The entity's Position and Scale are applied to it,
+  // its Rotation isn't. Only collides with BoxColliders on bodies that have a Velocity.
+  struct MeshCollider {
+    std::shared_ptr<const plugins::physics::MeshBvh> bvh;
+  };
+
+  // Added to bodies whose island has been at rest for a while. Sleeping bodies are skipped by the physics step until
+  // something touches them or their Velocity is replaced.
+  struct Sleeping {};
 };
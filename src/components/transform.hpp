@@ -20,4 +20,15 @@ namespace components {
   struct GlobalTransform {
     glm::mat4x4 value;
   };
+
+  // Set whenever an entity's local transform or parent changes, cleared once its GlobalTransform is recomputed in
+  // Schedule::PostUpdate.
+  struct TransformDirty {};
+
+  // Position / Rotation as of the previous fixed step.
+  // Entities with this are rendered blended between that and their current state by resources::Time::fixedAlpha.
+  struct Interpolated {
+    glm::vec3 previousPosition;
+    glm::quat previousRotation;
+  };
 };
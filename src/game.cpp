@@ -1,8 +1,41 @@
 #include "game.hpp"
 
 #include <glm/ext/matrix_transform.hpp>
+#include <cmath>
 #include <string>
 
+#include "resources/time.hpp"
+
+static const char* scheduleName(Schedule schedule) {
+  switch (schedule) {
+  case Schedule::Startup:
+    return "Startup";
+  case Schedule::Update:
+    return "Update";
+  case Schedule::PreFixedUpdate:
+    return "PreFixedUpdate";
+  case Schedule::FixedUpdate:
+    return "FixedUpdate";
+  case Schedule::PostUpdate:
+    return "PostUpdate";
+  case Schedule::Render:
+    return "Render";
+  case Schedule::Exit:
+    return "Exit";
+  }
+
+  return "Unknown";
+}
+
+Game::Game() : threadPool(std::make_shared<util::ThreadPool>()) {
+  addResource(threadPool);
+
+  for (auto schedule : {Schedule::Startup, Schedule::Update, Schedule::PreFixedUpdate, Schedule::FixedUpdate,
+                        Schedule::PostUpdate, Schedule::Render, Schedule::Exit}) {
+    scheduleProfileScopes[schedule] = profiler.addScope(scheduleName(schedule), "schedule");
+  }
+}
+
 std::expected<bool, std::string> Game::start() {
   isRunning = true;
 
@@ -11,12 +44,19 @@ std::expected<bool, std::string> Game::start() {
     return std::unexpected(startupResult.error());
   }
 
+  profiler.beginFrame();
+
   while (isRunning) {
     auto updateResult = runSchedule(Schedule::Update);
     if (!updateResult) {
       return std::unexpected(updateResult.error());
     }
 
+    auto fixedUpdateResult = runFixedUpdate();
+    if (!fixedUpdateResult) {
+      return std::unexpected(fixedUpdateResult.error());
+    }
+
     auto postUpdateResult = runSchedule(Schedule::PostUpdate);
     if (!postUpdateResult) {
       return std::unexpected(postUpdateResult.error());
@@ -26,6 +66,13 @@ std::expected<bool, std::string> Game::start() {
     if (!renderResult) {
       return std::unexpected(renderResult.error());
     }
+
+    profiler.endFrame();
+
+    frameCount++;
+    if (frameLimit.has_value() && frameCount >= frameLimit.value()) {
+      requestExit();
+    }
   }
 
   auto exitResult = runSchedule(Schedule::Exit);
@@ -36,6 +83,70 @@ std::expected<bool, std::string> Game::start() {
   return true;
 }
 
+std::expected<void, std::string> Game::runFixedUpdate() {
+  auto* time = findResource<resources::Time>();
+  if (!time || time->fixedDeltaTime <= 0.0f) {
+    return {};
+  }
+
+  time->fixedAccumulator += time->deltaTime;
+
+  uint32_t steps = 0;
+  while (time->fixedAccumulator >= time->fixedDeltaTime) {
+    if (steps >= time->maxFixedStepsPerFrame) {
+      // Spiral of death guard, give up on catching up and only keep the partial step
+      time->fixedAccumulator = std::fmod(time->fixedAccumulator, time->fixedDeltaTime);
+      break;
+    }
+
+    auto preResult = runSchedule(Schedule::PreFixedUpdate);
+    if (!preResult) {
+      return std::unexpected(preResult.error());
+    }
+
+    auto result = runSchedule(Schedule::FixedUpdate);
+    if (!result) {
+      return std::unexpected(result.error());
+    }
+
+    time->fixedAccumulator -= time->fixedDeltaTime;
+    steps++;
+  }
+
+  time->fixedAlpha = time->fixedAccumulator / time->fixedDeltaTime;
+
+  return {};
+}
+
+std::expected<void, std::string> Game::runSchedule(Schedule schedule) {
+  auto it = scheduledSystems.find(schedule);
+  if (it == scheduledSystems.end()) {
+    return {};
+  }
+
+  auto begin = scheduler::Clock::now();
+  auto result = it->second.run(*threadPool, profiler);
+  profiler.record(scheduleProfileScopes.at(schedule), begin, scheduler::Clock::now());
+
+  return result;
+}
+
 void Game::requestExit() {
   isRunning = false;
 }
+
+void Game::setFrameLimit(std::optional<uint64_t> limit) noexcept {
+  frameLimit = limit;
+}
+
+uint64_t Game::getFrameCount() const noexcept {
+  return frameCount;
+}
+
+const std::shared_ptr<util::ThreadPool>& Game::getThreadPool() const noexcept {
+  return threadPool;
+}
+
+scheduler::Profiler& Game::getProfiler() noexcept {
+  return profiler;
+}
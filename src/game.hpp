@@ -1,12 +1,14 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 #include <expected>
 #include <tuple>
-#include <typeindex>
-#include <any>
+#include <typeinfo>
 #include <stdexcept>
 #include <entt/entt.hpp>
 
@@ -20,9 +22,18 @@
 #include "plugins/time/time.hpp"
 #include "plugins/entt/entt.hpp"
 
+#include "scheduler/access.hpp"
+#include "scheduler/graph.hpp"
+#include "scheduler/profiler.hpp"
+#include "util/thread-pool.hpp"
+#include "util/type.hpp"
+
 enum class Schedule {
   Startup,
   Update,
+  // Before every FixedUpdate step, for anything that has to see the state the step starts from
+  PreFixedUpdate,
+  FixedUpdate,
   PostUpdate,
   Render,
   Exit
@@ -30,6 +41,9 @@ enum class Schedule {
 
 class Game;
 
+using scheduler::Read;
+using scheduler::Write;
+
 template <typename T>
 concept Plugin = requires(T plugin, Game& game) { plugin.build(game); };
 
@@ -46,9 +60,21 @@ template <Plugin... Plugins> struct PluginGroup {
 
 class Game {
 public:
+  Game();
+
   std::expected<bool, std::string> start();
   void requestExit();
 
+  // Exit on its own after this many frames, for benchmarks / CI
+  void setFrameLimit(std::optional<uint64_t> limit) noexcept;
+  [[nodiscard]] uint64_t getFrameCount() const noexcept;
+
+  // Worker pool the scheduler runs systems on, also available to systems as a resource
+  [[nodiscard]] const std::shared_ptr<util::ThreadPool>& getThreadPool() const noexcept;
+
+  // Rolling timings per system / schedule / frame, and Chrome trace capture
+  [[nodiscard]] scheduler::Profiler& getProfiler() noexcept;
+
   template <Plugin T> void addPlugin(T plugin) {
     plugin.build(*this);
   }
@@ -58,50 +84,69 @@ public:
     plugin.build(*this);
   }
 
+  // Systems are labelled in profiles by their callable's type unless given a name
   template <typename Func> void addSystem(Schedule schedule, Func&& system) {
-    addSystemImpl(schedule, std::forward<Func>(system));
+    addSystemImpl(schedule, util::type::nameOf<std::decay_t<Func>>(), std::forward<Func>(system));
+  }
+
+  template <typename Func> void addSystem(Schedule schedule, std::string name, Func&& system) {
+    addSystemImpl(schedule, std::move(name), std::forward<Func>(system));
   }
 
 private:
   // SFINAE helper to detect function signatures and extract parameter types
-  template <typename Func> void addSystemImpl(Schedule schedule, Func&& system) {
+  template <typename Func> void addSystemImpl(Schedule schedule, std::string name, Func&& system) {
     if constexpr (std::is_function_v<std::remove_pointer_t<std::decay_t<Func>>>) {
       // Function pointer case
-      addSystemFromSignature(schedule, std::forward<Func>(system), std::decay_t<Func>{});
+      addSystemFromSignature(schedule, std::move(name), std::forward<Func>(system), std::decay_t<Func>{});
     } else {
       // Lambda/functor case - use operator()
-      addSystemFromSignature(schedule, std::forward<Func>(system), &Func::operator());
+      addSystemFromSignature(schedule, std::move(name), std::forward<Func>(system), &Func::operator());
     }
   }
 
   // Specialization for function pointers
   template <typename Func, typename R, typename... Args>
-  void addSystemFromSignature(Schedule schedule, Func&& system, R (*)(Args...)) {
-    addSystemInternal<std::decay_t<Args>...>(schedule, std::forward<Func>(system));
+  void addSystemFromSignature(Schedule schedule, std::string name, Func&& system, R (*)(Args...)) {
+    addSystemInternal<Args...>(schedule, std::move(name), std::forward<Func>(system));
   }
 
   // Specialization for const member functions (lambdas)
   template <typename Func, typename Class, typename R, typename... Args>
-  void addSystemFromSignature(Schedule schedule, Func&& system, R (Class::*)(Args...) const) {
-    addSystemInternal<std::decay_t<Args>...>(schedule, std::forward<Func>(system));
+  void addSystemFromSignature(Schedule schedule, std::string name, Func&& system, R (Class::*)(Args...) const) {
+    addSystemInternal<Args...>(schedule, std::move(name), std::forward<Func>(system));
   }
 
   // Specialization for non-const member functions
   template <typename Func, typename Class, typename R, typename... Args>
-  void addSystemFromSignature(Schedule schedule, Func&& system, R (Class::*)(Args...)) {
-    addSystemInternal<std::decay_t<Args>...>(schedule, std::forward<Func>(system));
+  void addSystemFromSignature(Schedule schedule, std::string name, Func&& system, R (Class::*)(Args...)) {
+    addSystemInternal<Args...>(schedule, std::move(name), std::forward<Func>(system));
   }
 
   // The actual implementation
-  template <typename... Resources, typename Func> void addSystemInternal(Schedule schedule, Func&& system) {
-    scheduledSystems[schedule].emplace_back([this, system = std::forward<Func>(system)]() -> std::expected<void, std::string> {
-      using ReturnType = std::invoke_result_t<Func, Resources&...>;
+  // Params are the system's parameter types as declared, so constness / references decide the access it gets.
+  // Resource pointers are looked up on the first run and cached, as slots never move once created.
+  template <typename... Params, typename Func> void addSystemInternal(Schedule schedule, std::string name, Func&& system) {
+    using CachedResources = std::tuple<typename scheduler::SystemParam<Params>::Resource*...>;
+
+    auto run = [this, system = std::forward<Func>(system), cached = CachedResources{},
+                isResolved = false]() mutable -> std::expected<void, std::string> {
+      using ReturnType = std::invoke_result_t<Func, Params...>;
+
+      if (!isResolved) {
+        cached = CachedResources{&getResource<typename scheduler::SystemParam<Params>::Resource>()...};
+        isResolved = true;
+      }
+
+      auto call = [&system](auto*... resources) -> decltype(auto) {
+        return system(scheduler::SystemParam<Params>::fetch(*resources)...);
+      };
 
       if constexpr (std::is_same_v<ReturnType, void>) {
-        system(getResource<Resources>()...);
+        std::apply(call, cached);
         return {};
       } else if constexpr (std::is_same_v<ReturnType, std::expected<void, std::string>>) {
-        return system(getResource<Resources>()...);
+        return std::apply(call, cached);
       } else {
         static_assert(/* clang-format off */
           std::is_same_v<ReturnType, void> ||
@@ -109,43 +154,64 @@ private:
           "System functions must return either void or std::expected<void, std::string>"
         ); /* clang-format on */
       }
-    });
+    };
+
+    scheduledSystems[schedule].addSystem({/* clang-format off */
+      .run = std::move(run),
+      .access = scheduler::accessOf<Params...>(),
+      .profileScope = profiler.addScope(std::move(name), "system")
+    }); /* clang-format on */
   }
 
 public:
+  // Re-adding a resource assigns into its existing slot, so pointers cached by systems stay valid
   template <typename T> void addResource(T&& resource) {
-    resources[std::type_index(typeid(T))] = std::make_any<T>(std::forward<T>(resource));
+    using Resource = std::decay_t<T>;
+
+    auto id = scheduler::resourceId<Resource>();
+    if (id >= resourceSlots.size()) {
+      resourceSlots.resize(id + 1);
+    }
+
+    if (auto& slot = resourceSlots[id]) {
+      *static_cast<Resource*>(slot.get()) = std::forward<T>(resource);
+    } else {
+      slot = std::make_shared<Resource>(std::forward<T>(resource));
+    }
   }
 
-  template <typename T> void addResource(const T& resource) {
-    resources[std::type_index(typeid(T))] = std::make_any<T>(resource);
+  // Null if never added. Not synchronized with running systems, so meant for reading results once start returns.
+  template <typename T> T* findResource() noexcept {
+    auto id = scheduler::resourceId<T>();
+    if (id >= resourceSlots.size()) {
+      return nullptr;
+    }
+
+    return static_cast<T*>(resourceSlots[id].get());
   }
 
 private:
-  bool isRunning;
-  std::unordered_map<std::type_index, std::any> resources;
-  std::unordered_map<Schedule, std::vector<std::function<std::expected<void, std::string>()>>> scheduledSystems;
+  std::atomic<bool> isRunning = false;
+  uint64_t frameCount = 0;
+  std::optional<uint64_t> frameLimit;
+  std::vector<std::shared_ptr<void>> resourceSlots; // Indexed by scheduler::ResourceId
+  std::unordered_map<Schedule, scheduler::Graph> scheduledSystems;
+  std::shared_ptr<util::ThreadPool> threadPool;
+  scheduler::Profiler profiler;
+  std::unordered_map<Schedule, size_t> scheduleProfileScopes;
 
   template <typename T> T& getResource() {
-    auto it = resources.find(std::type_index(typeid(T)));
-    if (it == resources.end()) {
+    auto* resource = findResource<T>();
+    if (!resource) {
       throw std::runtime_error("Resource type not registered: " + std::string(typeid(T).name()));
     }
 
-    return std::any_cast<T&>(it->second);
+    return *resource;
   }
 
-  std::expected<void, std::string> runSchedule(Schedule schedule) {
-    if (auto it = scheduledSystems.find(schedule); it != scheduledSystems.end()) {
-      for (auto& system : it->second) {
-        auto result = system();
-        if (!result) {
-          return std::unexpected(result.error());
-        }
-      }
-    }
-    return {};
-  }
+  std::expected<void, std::string> runSchedule(Schedule schedule);
+
+  std::expected<void, std::string> runFixedUpdate();
 
   // ECS
 };
@@ -162,7 +228,8 @@ private:
   PluginGroup<plugins::EnTT, plugins::Transform, plugins::Time, plugins::Render, plugins::Input> pluginGroup;
 
 public:
-  DefaultPlugins() : pluginGroup(plugins::EnTT{}, plugins::Transform{}, plugins::Time{}, plugins::Render{}, plugins::Input{}) {
+  DefaultPlugins(plugins::Time time = {}, plugins::Render render = {})
+      : pluginGroup(plugins::EnTT{}, plugins::Transform{}, time, render, plugins::Input{}) {
   }
 
   void build(Game& game) {
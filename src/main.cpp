@@ -1,28 +1,177 @@
 #include "game.hpp"
 
+#include <chrono>
+#include <charconv>
+#include <filesystem>
+#include <optional>
 #include <print>
+#include <string_view>
+#include <vector>
 
 #include "plugins/debug-cam-controller/debug-cam-controller.hpp"
 #include "plugins/physics/physics.hpp"
 
+#include "render/gpu-timers.hpp"
+
 #include "util/error.hpp"
 
 #include "scenes/test.hpp"
 #include "scenes/nfs.hpp"
 
-int main() {
+struct RunOptions {
+  std::string scene = "test";
+  bool isHeadless = false;
+  bool isGpuCulled = false;
+  bool isOcclusionCulled = false;
+  bool hasDepthPrePass = false;
+  std::optional<uint64_t> frameLimit;
+  std::optional<float> syntheticDeltaTime;
+  std::optional<std::filesystem::path> statsPath;
+};
+
+template <typename T> static std::expected<T, std::string> parseNumber(std::string_view flag, std::string_view value) {
+  T result;
+  auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+  if (error != std::errc() || end != value.data() + value.size()) {
+    return std::unexpected(std::format("Invalid value for {}: '{}'", flag, value));
+  }
+
+  return result;
+}
+
+static std::expected<RunOptions, std::string> parseArgs(int argc, char** argv) {
+  RunOptions options;
+
+  for (int i = 1; i < argc; ++i) {
+    std::string_view arg = argv[i];
+
+    if (arg == "--headless") {
+      options.isHeadless = true;
+      continue;
+    }
+
+    if (arg == "--gpu-culling") {
+      options.isGpuCulled = true;
+      continue;
+    }
+
+    if (arg == "--occlusion-culling") {
+      options.isOcclusionCulled = true;
+      continue;
+    }
+
+    if (arg == "--depth-prepass") {
+      options.hasDepthPrePass = true;
+      continue;
+    }
+
+    if (i + 1 >= argc) {
+      return std::unexpected(std::format("Unknown argument or missing value: '{}'", arg));
+    }
+
+    std::string_view value = argv[++i];
+    if (arg == "--scene") {
+      options.scene = value;
+    } else if (arg == "--frames") {
+      auto frames = parseNumber<uint64_t>(arg, value);
+      if (!frames.has_value()) {
+        return std::unexpected(frames.error());
+      }
+      options.frameLimit = frames.value();
+    } else if (arg == "--delta-time") {
+      auto deltaTime = parseNumber<float>(arg, value);
+      if (!deltaTime.has_value()) {
+        return std::unexpected(deltaTime.error());
+      }
+      options.syntheticDeltaTime = deltaTime.value();
+    } else if (arg == "--stats") {
+      options.statsPath = value;
+    } else {
+      return std::unexpected(std::format("Unknown argument: '{}'", arg));
+    }
+  }
+
+  // Headless runs are for measurements, so make them repeatable unless told otherwise
+  if (options.isHeadless && !options.syntheticDeltaTime.has_value()) {
+    options.syntheticDeltaTime = 1.0f / 60.0f;
+  }
+
+  return options;
+}
+
+int main(int argc, char** argv) {
+  auto options = parseArgs(argc, argv);
+  if (!options.has_value()) {
+    std::println(stderr, "{}", options.error());
+    std::println(stderr, "Usage: qun [--scene test|nfs] [--headless] [--gpu-culling] [--occlusion-culling] [--frames N]");
+    std::println(stderr, "           [--depth-prepass] [--delta-time SECONDS] [--stats FILE.csv|FILE.json]");
+    return EXIT_FAILURE;
+  }
+
   auto game = std::make_unique<Game>();
-  game->addPlugin(DefaultPlugins());
+  game->addPlugin(DefaultPlugins(/* clang-format off */
+    plugins::Time{.syntheticDeltaTime = options->syntheticDeltaTime},
+    plugins::Render{
+      .isHeadless = options->isHeadless,
+      .isGpuCulled = options->isGpuCulled,
+      .isOcclusionCulled = options->isOcclusionCulled,
+      .hasDepthPrePass = options->hasDepthPrePass
+    }
+  )); /* clang-format on */
   game->addPlugin(plugins::Physics());
-  game->addPlugin(plugins::DebugCamController());
-  game->addSystem(Schedule::Startup, scenes::test::startup);
-  // game->addPlugin(scenes::nfs::NFS());
 
+  if (options->scene == "test") {
+    game->addPlugin(plugins::DebugCamController());
+    game->addSystem(Schedule::Startup, scenes::test::startup);
+  } else if (options->scene == "nfs") {
+    game->addPlugin(scenes::nfs::NFS());
+  } else {
+    std::println(stderr, "Unknown scene: '{}'", options->scene);
+    return EXIT_FAILURE;
+  }
+
+  game->setFrameLimit(options->frameLimit);
+
+  auto startTime = std::chrono::steady_clock::now();
   auto result = game->start();
   if (!result.has_value()) {
     std::println(stderr, "Failed to start game:\n\t{}", util::error::indent(result.error()));
     return EXIT_FAILURE;
   }
 
+  // Only set if the renderer came up
+  auto* gpuTimers = game->findResource<std::shared_ptr<render::GpuTimers>>();
+  bool hasGpuTimers = gpuTimers && *gpuTimers;
+
+  if (options->isHeadless || options->frameLimit.has_value()) {
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    auto frames = game->getFrameCount();
+
+    std::println("Ran {} frames in {:.3f}s ({:.3f} ms/frame)", frames, seconds, frames ? seconds * 1000.0 / frames : 0.0);
+    std::print("{}", game->getProfiler().report());
+    if (hasGpuTimers) {
+      std::print("{}", (*gpuTimers)->report());
+    }
+  }
+
+  if (options->statsPath.has_value()) {
+    const auto& profiler = game->getProfiler();
+
+    std::vector<const scheduler::ProfileScope*> scopes;
+    for (size_t i = 0; i < profiler.getScopeCount(); ++i) {
+      scopes.push_back(&profiler.getScope(i));
+    }
+
+    for (size_t i = 0; hasGpuTimers && i < (*gpuTimers)->getScopeCount(); ++i) {
+      scopes.push_back(&(*gpuTimers)->getScope(i));
+    }
+
+    auto statsResult = scheduler::writeStats(options->statsPath.value(), scopes);
+    if (!statsResult.has_value()) {
+      std::println(stderr, "{}", statsResult.error());
+      return EXIT_FAILURE;
+    }
+  }
+
   return EXIT_SUCCESS;
 }
@@ -28,8 +28,8 @@ void plugins::DebugCamController::build(Game& game) {
   });
 
   /* clang-format off */
-  game.addSystem(Schedule::Update, [](
-    resources::Time& time,
+  game.addSystem(Schedule::Update, "debugCam::update", [](
+    const resources::Time& time,
     std::shared_ptr<Renderer> renderer,
     std::shared_ptr<CameraState> cameraState
   ) {
@@ -11,7 +11,7 @@
 
 void plugins::Input::build(Game& game) {
   /* clang-format off */
-  game.addSystem(Schedule::Update, [&](std::shared_ptr<Window>& window){
+  game.addSystem(Schedule::Update, "input::poll", [&](std::shared_ptr<Window>& window){
     glfwPollEvents();
 
     if (window->shouldClose()) {
@@ -23,7 +23,7 @@ void plugins::Input::build(Game& game) {
     }
   }); /* clang-format on */
 
-  game.addSystem(Schedule::PostUpdate, []() {
+  game.addSystem(Schedule::PostUpdate, "input::reset", []() {
     input::Keyboard::resetCurrentKeyMaps();
     input::Mouse::resetCurrentMouseMaps();
   });
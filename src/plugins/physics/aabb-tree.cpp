@@ -0,0 +1,423 @@
+#include "aabb-tree.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "components/physics.hpp"
+#include "components/transform.hpp"
+
+static plugins::physics::Aabb fatten(const plugins::physics::Aabb& bounds) {
+  glm::vec3 margin(plugins::physics::AabbTree::FAT_MARGIN);
+  return {.min = bounds.min - margin, .max = bounds.max + margin};
+}
+
+int32_t plugins::physics::AabbTree::allocateNode() {
+  if (freeList == NULL_NODE) {
+    nodes.emplace_back();
+    return static_cast<int32_t>(nodes.size() - 1);
+  }
+
+  int32_t nodeId = freeList;
+  freeList = nodes[nodeId].parent;
+  nodes[nodeId] = Node{};
+
+  return nodeId;
+}
+
+void plugins::physics::AabbTree::freeNode(int32_t nodeId) {
+  nodes[nodeId].parent = freeList;
+  nodes[nodeId].height = -1;
+  nodes[nodeId].entity = entt::null;
+  freeList = nodeId;
+}
+
+int32_t plugins::physics::AabbTree::createProxy(const Aabb& bounds, entt::entity entity) {
+  int32_t proxyId = allocateNode();
+
+  Node& node = nodes[proxyId];
+  node.bounds = bounds;
+  node.fatBounds = fatten(bounds);
+  node.height = 0;
+  node.entity = entity;
+
+  insertLeaf(proxyId);
+  proxyCount++;
+
+  return proxyId;
+}
+
+void plugins::physics::AabbTree::destroyProxy(int32_t proxyId) {
+  removeLeaf(proxyId);
+  freeNode(proxyId);
+  proxyCount--;
+}
+
+bool plugins::physics::AabbTree::moveProxy(int32_t proxyId, const Aabb& bounds) {
+  Node& node = nodes[proxyId];
+  node.bounds = bounds;
+
+  // Still inside its fat box, and that box hasn't been left far bigger than needed (eg. after shrinking)
+  Aabb largest = {.min = bounds.min - glm::vec3(4.0f * FAT_MARGIN), .max = bounds.max + glm::vec3(4.0f * FAT_MARGIN)};
+  if (node.fatBounds.contains(bounds) && largest.contains(node.fatBounds)) {
+    return false;
+  }
+
+  removeLeaf(proxyId);
+  nodes[proxyId].fatBounds = fatten(bounds);
+  insertLeaf(proxyId);
+
+  return true;
+}
+
+void plugins::physics::AabbTree::sync(const entt::registry& registry) {
+  syncStep++;
+
+  auto view = registry.view<::components::Position, ::components::BoxCollider>();
+  for (entt::entity entity : view) {
+    auto bounds = Aabb::fromCenter(view.get<::components::Position>(entity).value,
+                                   view.get<::components::BoxCollider>(entity).halfExtents);
+
+    auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= entityProxies.size()) {
+      entityProxies.resize(id + 1, NULL_NODE);
+    }
+
+    int32_t& proxyId = entityProxies[id];
+    if (proxyId == NULL_NODE || nodes[proxyId].entity != entity) {
+      proxyId = createProxy(bounds, entity);
+    } else {
+      moveProxy(proxyId, bounds);
+    }
+
+    nodes[proxyId].lastSeenStep = syncStep;
+  }
+
+  // Whatever wasn't seen lost its collider or was destroyed
+  for (size_t nodeId = 0; nodeId < nodes.size(); ++nodeId) {
+    const Node& node = nodes[nodeId];
+    if (node.height == 0 && node.lastSeenStep != syncStep) {
+      auto id = static_cast<size_t>(entt::to_entity(node.entity));
+      if (entityProxies[id] == static_cast<int32_t>(nodeId)) {
+        entityProxies[id] = NULL_NODE;
+      }
+
+      destroyProxy(static_cast<int32_t>(nodeId));
+    }
+  }
+}
+
+void plugins::physics::AabbTree::insertLeaf(int32_t leaf) {
+  if (root == NULL_NODE) {
+    root = leaf;
+    nodes[root].parent = NULL_NODE;
+    return;
+  }
+
+  // Walk down towards the sibling that grows the tree's surface area the least
+  Aabb leafBounds = nodes[leaf].fatBounds;
+  int32_t index = root;
+
+  while (!nodes[index].isLeaf()) {
+    const Node& node = nodes[index];
+
+    float area = node.fatBounds.surfaceArea();
+    float combinedArea = node.fatBounds.merge(leafBounds).surfaceArea();
+
+    // Cost of pairing with this node, and the cost pushed down onto either child if we descend
+    float cost = 2.0f * combinedArea;
+    float inheritanceCost = 2.0f * (combinedArea - area);
+
+    auto descendCost = [&](int32_t child) {
+      const Aabb& childBounds = nodes[child].fatBounds;
+      float mergedArea = childBounds.merge(leafBounds).surfaceArea();
+
+      if (nodes[child].isLeaf()) {
+        return mergedArea + inheritanceCost;
+      }
+
+      return mergedArea - childBounds.surfaceArea() + inheritanceCost;
+    };
+
+    float cost1 = descendCost(node.child1);
+    float cost2 = descendCost(node.child2);
+
+    if (cost < cost1 && cost < cost2) {
+      break;
+    }
+
+    index = cost1 < cost2 ? node.child1 : node.child2;
+  }
+
+  int32_t sibling = index;
+  int32_t oldParent = nodes[sibling].parent;
+
+  int32_t newParent = allocateNode();
+  nodes[newParent].parent = oldParent;
+  nodes[newParent].fatBounds = nodes[sibling].fatBounds.merge(leafBounds);
+  nodes[newParent].height = nodes[sibling].height + 1;
+  nodes[newParent].child1 = sibling;
+  nodes[newParent].child2 = leaf;
+
+  if (oldParent == NULL_NODE) {
+    root = newParent;
+  } else if (nodes[oldParent].child1 == sibling) {
+    nodes[oldParent].child1 = newParent;
+  } else {
+    nodes[oldParent].child2 = newParent;
+  }
+
+  nodes[sibling].parent = newParent;
+  nodes[leaf].parent = newParent;
+
+  refitAncestors(nodes[leaf].parent);
+}
+
+void plugins::physics::AabbTree::removeLeaf(int32_t leaf) {
+  if (leaf == root) {
+    root = NULL_NODE;
+    return;
+  }
+
+  int32_t parent = nodes[leaf].parent;
+  int32_t grandParent = nodes[parent].parent;
+  int32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+  // The parent goes away and the sibling takes its place
+  if (grandParent == NULL_NODE) {
+    root = sibling;
+    nodes[sibling].parent = NULL_NODE;
+    freeNode(parent);
+    return;
+  }
+
+  if (nodes[grandParent].child1 == parent) {
+    nodes[grandParent].child1 = sibling;
+  } else {
+    nodes[grandParent].child2 = sibling;
+  }
+
+  nodes[sibling].parent = grandParent;
+  freeNode(parent);
+
+  refitAncestors(grandParent);
+}
+
+void plugins::physics::AabbTree::refitAncestors(int32_t nodeId) {
+  while (nodeId != NULL_NODE) {
+    nodeId = balance(nodeId);
+
+    Node& node = nodes[nodeId];
+    const Node& child1 = nodes[node.child1];
+    const Node& child2 = nodes[node.child2];
+
+    node.height = 1 + std::max(child1.height, child2.height);
+    node.fatBounds = child1.fatBounds.merge(child2.fatBounds);
+
+    nodeId = node.parent;
+  }
+}
+
+// Rotates nodeA's taller grandchild up if its children are out of balance by more than one level.
+// Returns the node now at nodeA's old position.
+int32_t plugins::physics::AabbTree::balance(int32_t nodeA) {
+  Node& a = nodes[nodeA];
+  if (a.isLeaf() || a.height < 2) {
+    return nodeA;
+  }
+
+  int32_t nodeB = a.child1;
+  int32_t nodeC = a.child2;
+  int32_t heightDifference = nodes[nodeC].height - nodes[nodeB].height;
+
+  if (heightDifference >= -1 && heightDifference <= 1) {
+    return nodeA;
+  }
+
+  // Promote the taller child (up) and hand one of its children (kept) down to nodeA in its place
+  bool isRight = heightDifference > 1;
+  int32_t up = isRight ? nodeC : nodeB;
+  int32_t other = isRight ? nodeB : nodeC;
+
+  Node& upNode = nodes[up];
+  int32_t upChild1 = upNode.child1;
+  int32_t upChild2 = upNode.child2;
+
+  // up takes nodeA's place under nodeA's parent
+  upNode.child1 = nodeA;
+  upNode.parent = a.parent;
+  a.parent = up;
+
+  if (upNode.parent == NULL_NODE) {
+    root = up;
+  } else if (nodes[upNode.parent].child1 == nodeA) {
+    nodes[upNode.parent].child1 = up;
+  } else {
+    nodes[upNode.parent].child2 = up;
+  }
+
+  // The taller of up's children stays with up, the shorter one moves down into nodeA
+  int32_t kept = nodes[upChild1].height > nodes[upChild2].height ? upChild1 : upChild2;
+  int32_t moved = kept == upChild1 ? upChild2 : upChild1;
+
+  upNode.child2 = kept;
+  nodes[kept].parent = up;
+
+  if (isRight) {
+    a.child2 = moved;
+  } else {
+    a.child1 = moved;
+  }
+  nodes[moved].parent = nodeA;
+
+  a.fatBounds = nodes[other].fatBounds.merge(nodes[moved].fatBounds);
+  a.height = 1 + std::max(nodes[other].height, nodes[moved].height);
+
+  upNode.fatBounds = a.fatBounds.merge(nodes[kept].fatBounds);
+  upNode.height = 1 + std::max(a.height, nodes[kept].height);
+
+  return up;
+}
+
+// Slab test, giving the entry distance and the axis entered through (-1 if the ray starts inside)
+/* clang-format off */
+static bool intersectRay(
+  const plugins::physics::Aabb& box,
+  const glm::vec3& origin,
+  const glm::vec3& inverseDirection,
+  float maxDistance,
+  float& distance,
+  int& axis
+) { /* clang-format on */
+  float tMin = 0.0f;
+  float tMax = maxDistance;
+  axis = -1;
+
+  for (int i = 0; i < 3; ++i) {
+    float t1 = (box.min[i] - origin[i]) * inverseDirection[i];
+    float t2 = (box.max[i] - origin[i]) * inverseDirection[i];
+    if (t1 > t2) {
+      std::swap(t1, t2);
+    }
+
+    if (t1 > tMin) {
+      tMin = t1;
+      axis = i;
+    }
+
+    // NaN (origin exactly on a slab parallel to the ray) leaves tMax as is
+    tMax = std::min(tMax, t2);
+
+    if (tMin > tMax) {
+      return false;
+    }
+  }
+
+  distance = tMin;
+  return true;
+}
+
+/* clang-format off */
+std::optional<plugins::physics::RaycastHit> plugins::physics::AabbTree::raycast(
+  const glm::vec3& origin,
+  const glm::vec3& direction,
+  float maxDistance
+) const { /* clang-format on */
+  if (root == NULL_NODE) {
+    return std::nullopt;
+  }
+
+  glm::vec3 inverseDirection = 1.0f / direction;
+
+  std::optional<RaycastHit> closest;
+  float closestDistance = maxDistance;
+
+  std::vector<int32_t> stack;
+  stack.reserve(64);
+  stack.push_back(root);
+
+  while (!stack.empty()) {
+    int32_t nodeId = stack.back();
+    stack.pop_back();
+
+    const Node& node = nodes[nodeId];
+
+    float distance;
+    int axis;
+    if (!intersectRay(node.fatBounds, origin, inverseDirection, closestDistance, distance, axis)) {
+      continue;
+    }
+
+    if (!node.isLeaf()) {
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+      continue;
+    }
+
+    if (!intersectRay(node.bounds, origin, inverseDirection, closestDistance, distance, axis)) {
+      continue;
+    }
+
+    glm::vec3 normal = -direction;
+    if (axis != -1) {
+      normal = glm::vec3(0.0f);
+      normal[axis] = direction[axis] > 0.0f ? -1.0f : 1.0f;
+    }
+
+    closestDistance = distance;
+    closest = RaycastHit{.entity = node.entity, .distance = distance, .point = origin + direction * distance, .normal = normal};
+  }
+
+  return closest;
+}
+
+std::vector<entt::entity> plugins::physics::AabbTree::overlapBox(const glm::vec3& center, const glm::vec3& halfExtents) const {
+  Aabb box = Aabb::fromCenter(center, halfExtents);
+  std::vector<entt::entity> result;
+
+  query(box, [&](int32_t proxyId) {
+    if (nodes[proxyId].bounds.overlaps(box)) {
+      result.push_back(nodes[proxyId].entity);
+    }
+    return true;
+  });
+
+  return result;
+}
+
+std::vector<entt::entity> plugins::physics::AabbTree::overlapSphere(const glm::vec3& center, float radius) const {
+  std::vector<entt::entity> result;
+
+  query(Aabb::fromCenter(center, glm::vec3(radius)), [&](int32_t proxyId) {
+    const Aabb& bounds = nodes[proxyId].bounds;
+
+    glm::vec3 closestPoint = glm::clamp(center, bounds.min, bounds.max);
+    glm::vec3 offset = closestPoint - center;
+    if (glm::dot(offset, offset) <= radius * radius) {
+      result.push_back(nodes[proxyId].entity);
+    }
+    return true;
+  });
+
+  return result;
+}
+
+entt::entity plugins::physics::AabbTree::getEntity(int32_t proxyId) const noexcept {
+  return nodes[proxyId].entity;
+}
+
+const plugins::physics::Aabb& plugins::physics::AabbTree::getBounds(int32_t proxyId) const noexcept {
+  return nodes[proxyId].bounds;
+}
+
+const plugins::physics::Aabb& plugins::physics::AabbTree::getFatBounds(int32_t proxyId) const noexcept {
+  return nodes[proxyId].fatBounds;
+}
+
+size_t plugins::physics::AabbTree::getProxyCount() const noexcept {
+  return proxyCount;
+}
+
+int32_t plugins::physics::AabbTree::getHeight() const noexcept {
+  return root == NULL_NODE ? 0 : nodes[root].height;
+}
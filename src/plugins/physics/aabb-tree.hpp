@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+
+namespace plugins::physics {
+  struct RaycastHit {
+    entt::entity entity;
+    float distance;
+    glm::vec3 point;
+    glm::vec3 normal;
+  };
+
+  // Dynamic bounding volume tree over every BoxCollider, for spatial queries from any system.
+  //
+  // Leaves store a fattened copy of their box, so small movements don't touch the tree at all. Anything that moves
+  // out of its fat box is reinserted, and the tree is kept balanced with rotations on the way back up.
+  //
+  // Kept in sync by Schedule::FixedUpdate after the physics step, so systems in Update see the latest fixed state.
+  // Systems only querying it should take Read<std::shared_ptr<plugins::physics::AabbTree>> to stay parallel.
+  class AabbTree {
+  public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    // How far fat boxes extend past the real one on each side
+    static constexpr float FAT_MARGIN = 0.1f;
+
+    int32_t createProxy(const Aabb& bounds, entt::entity entity);
+    void destroyProxy(int32_t proxyId);
+
+    // Returns whether the proxy had to be reinserted
+    bool moveProxy(int32_t proxyId, const Aabb& bounds);
+
+    // Creates, moves and destroys proxies to match every entity with a Position and BoxCollider
+    void sync(const entt::registry& registry);
+
+    // Calls fn(proxyId) for every proxy whose fat box overlaps bounds, until it returns false
+    template <typename Fn> void query(const Aabb& bounds, Fn&& fn) const;
+
+    // Closest box hit by the ray, if any within maxDistance. direction must be normalized.
+    /* clang-format off */
+    [[nodiscard]] std::optional<RaycastHit> raycast(
+      const glm::vec3& origin,
+      const glm::vec3& direction,
+      float maxDistance
+    ) const; /* clang-format on */
+
+    // Entities whose collider overlaps the box / sphere
+    [[nodiscard]] std::vector<entt::entity> overlapBox(const glm::vec3& center, const glm::vec3& halfExtents) const;
+    [[nodiscard]] std::vector<entt::entity> overlapSphere(const glm::vec3& center, float radius) const;
+
+    [[nodiscard]] entt::entity getEntity(int32_t proxyId) const noexcept;
+    [[nodiscard]] const Aabb& getBounds(int32_t proxyId) const noexcept;
+    [[nodiscard]] const Aabb& getFatBounds(int32_t proxyId) const noexcept;
+
+    [[nodiscard]] size_t getProxyCount() const noexcept;
+    [[nodiscard]] int32_t getHeight() const noexcept;
+
+  private:
+    struct Node {
+      Aabb fatBounds;
+
+      // Exact box, only meaningful for leaves
+      Aabb bounds;
+
+      // Next free node while on the free list
+      int32_t parent = NULL_NODE;
+      int32_t child1 = NULL_NODE;
+      int32_t child2 = NULL_NODE;
+
+      // 0 for leaves, -1 while free
+      int32_t height = -1;
+
+      entt::entity entity = entt::null;
+      uint64_t lastSeenStep = 0;
+
+      [[nodiscard]] bool isLeaf() const noexcept {
+        return child1 == NULL_NODE;
+      }
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+
+    // Refits and rebalances every ancestor of nodeId, starting from nodeId itself
+    void refitAncestors(int32_t nodeId);
+    int32_t balance(int32_t nodeA);
+
+    std::vector<Node> nodes;
+    int32_t root = NULL_NODE;
+    int32_t freeList = NULL_NODE;
+    size_t proxyCount = 0;
+
+    // Proxy of each entity, indexed by entity id. Stale entries are caught by comparing the stored entity.
+    std::vector<int32_t> entityProxies;
+    uint64_t syncStep = 0;
+  };
+
+  template <typename Fn> void AabbTree::query(const Aabb& bounds, Fn&& fn) const {
+    if (root == NULL_NODE) {
+      return;
+    }
+
+    std::vector<int32_t> stack;
+    stack.reserve(64);
+    stack.push_back(root);
+
+    while (!stack.empty()) {
+      int32_t nodeId = stack.back();
+      stack.pop_back();
+
+      const Node& node = nodes[nodeId];
+      if (!node.fatBounds.overlaps(bounds)) {
+        continue;
+      }
+
+      if (node.isLeaf()) {
+        if (!fn(nodeId)) {
+          return;
+        }
+        continue;
+      }
+
+      stack.push_back(node.child1);
+      stack.push_back(node.child2);
+    }
+  }
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace plugins::physics {
+  struct Aabb {
+    glm::vec3 min;
+    glm::vec3 max;
+
+    [[nodiscard]] static Aabb fromCenter(const glm::vec3& center, const glm::vec3& halfExtents) noexcept {
+      return {.min = center - halfExtents, .max = center + halfExtents};
+    }
+
+    [[nodiscard]] bool overlaps(const Aabb& other) const noexcept {
+      return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::lessThanEqual(other.min, max));
+    }
+
+    [[nodiscard]] bool contains(const Aabb& other) const noexcept {
+      return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::lessThanEqual(other.max, max));
+    }
+
+    [[nodiscard]] Aabb merge(const Aabb& other) const noexcept {
+      return {.min = glm::min(min, other.min), .max = glm::max(max, other.max)};
+    }
+
+    [[nodiscard]] float surfaceArea() const noexcept {
+      glm::vec3 size = max - min;
+      return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+  };
+};
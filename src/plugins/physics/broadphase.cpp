@@ -0,0 +1,110 @@
+#include "broadphase.hpp"
+
+#include <algorithm>
+
+#include "components/physics.hpp"
+#include "components/transform.hpp"
+
+void plugins::physics::SweepAndPrune::update(entt::registry& registry) {
+  step++;
+
+  auto view = registry.view<::components::Position, ::components::BoxCollider>();
+
+  auto markSeen = [this](entt::entity entity) {
+    auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id >= lastSeen.size()) {
+      lastSeen.resize(id + 1, 0);
+    }
+    lastSeen[id] = step;
+  };
+
+  // Keep last step's order for anything that's still around, new colliders go on the end
+  std::erase_if(proxies, [&](const Proxy& proxy) { return !registry.valid(proxy.entity) || !view.contains(proxy.entity); });
+  for (const auto& proxy : proxies) {
+    markSeen(proxy.entity);
+  }
+
+  size_t addedCount = 0;
+  for (entt::entity entity : view) {
+    auto id = static_cast<size_t>(entt::to_entity(entity));
+    if (id < lastSeen.size() && lastSeen[id] == step) {
+      continue;
+    }
+
+    proxies.push_back({.entity = entity, .bounds = {}, .isAwake = false});
+    markSeen(entity);
+    addedCount++;
+  }
+
+  if (proxies.empty()) {
+    return;
+  }
+
+  glm::vec3 sum(0.0f);
+  glm::vec3 sumSquared(0.0f);
+
+  for (auto& proxy : proxies) {
+    const auto& position = view.get<::components::Position>(proxy.entity).value;
+    const auto& halfExtents = view.get<::components::BoxCollider>(proxy.entity).halfExtents;
+
+    proxy.bounds = Aabb::fromCenter(position, halfExtents);
+    proxy.isAwake = /* clang-format off */
+      registry.all_of<::components::Velocity>(proxy.entity) &&
+      !registry.all_of<::components::Sleeping>(proxy.entity); /* clang-format on */
+
+    sum += position;
+    sumSquared += position * position;
+  }
+
+  // Sweep along the axis with the most spread, so as few boxes as possible share an interval
+  float count = static_cast<float>(proxies.size());
+  glm::vec3 variance = sumSquared / count - (sum / count) * (sum / count);
+
+  int previousAxis = axis;
+  axis = variance.x >= variance.y && variance.x >= variance.z ? 0 : (variance.y >= variance.z ? 1 : 2);
+
+  auto isBefore = [this](const Proxy& a, const Proxy& b) { return a.bounds.min[axis] < b.bounds.min[axis]; };
+
+  // Insertion sort is close to linear on last step's order, but not on a shuffled or mostly new list
+  if (axis != previousAxis || addedCount > proxies.size() / 4) {
+    std::sort(proxies.begin(), proxies.end(), isBefore);
+    return;
+  }
+
+  for (size_t i = 1; i < proxies.size(); ++i) {
+    Proxy proxy = proxies[i];
+
+    size_t j = i;
+    while (j > 0 && isBefore(proxy, proxies[j - 1])) {
+      proxies[j] = proxies[j - 1];
+      --j;
+    }
+
+    proxies[j] = proxy;
+  }
+}
+
+const std::vector<std::pair<entt::entity, entt::entity>>& plugins::physics::SweepAndPrune::findPairs() {
+  pairs.clear();
+
+  for (size_t i = 0; i < proxies.size(); ++i) {
+    const auto& proxy = proxies[i];
+
+    // Everything after this whose interval starts before ours ends overlaps on the sweep axis
+    for (size_t j = i + 1; j < proxies.size() && proxies[j].bounds.min[axis] <= proxy.bounds.max[axis]; ++j) {
+      // Resting and static bodies can't newly collide with each other
+      if (!proxy.isAwake && !proxies[j].isAwake) {
+        continue;
+      }
+
+      if (proxy.bounds.overlaps(proxies[j].bounds)) {
+        pairs.push_back(std::minmax(proxy.entity, proxies[j].entity));
+      }
+    }
+  }
+
+  // Collision response depends on the order pairs are resolved in, so keep it independent of the sweep order
+  std::sort(pairs.begin(), pairs.end());
+
+  return pairs;
+}
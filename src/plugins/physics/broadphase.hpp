@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <entt/entt.hpp>
+
+#include "aabb.hpp"
+
+namespace plugins::physics {
+  // Incremental sweep-and-prune over every BoxCollider.
+  //
+  // Boxes are kept sorted along whichever axis they're most spread out on. The order is kept between steps, so
+  // re-sorting is an insertion sort over an almost sorted list. Large static boxes (e.g. a baseplate) only walk the
+  // list once each, instead of being tested against every other box per box.
+  class SweepAndPrune {
+  public:
+    // Refreshes the boxes of every entity with a Position and BoxCollider, picking up new and removed ones
+    void update(entt::registry& registry);
+
+    // Pairs whose boxes overlap and where at least one side is awake and movable, smaller entity first, in a
+    // deterministic order
+    [[nodiscard]] const std::vector<std::pair<entt::entity, entt::entity>>& findPairs();
+
+  private:
+    struct Proxy {
+      entt::entity entity;
+      Aabb bounds;
+
+      // Has a Velocity and isn't Sleeping
+      bool isAwake;
+    };
+
+    std::vector<Proxy> proxies;
+    std::vector<std::pair<entt::entity, entt::entity>> pairs;
+
+    // Step each entity was last seen in, indexed by entity id
+    std::vector<uint64_t> lastSeen;
+    uint64_t step = 0;
+
+    int axis = 0;
+  };
+};
@@ -0,0 +1,58 @@
+#include "contact-cache.hpp"
+
+#include <algorithm>
+
+// Full entity values (including version), so a recycled entity doesn't inherit an old contact
+static uint64_t pairKey(entt::entity entity1, entt::entity entity2) noexcept {
+  return (static_cast<uint64_t>(entt::to_integral(entity1)) << 32) | static_cast<uint64_t>(entt::to_integral(entity2));
+}
+
+void plugins::physics::ContactCache::beginStep() noexcept {
+  step++;
+}
+
+plugins::physics::Contact& plugins::physics::ContactCache::touch(entt::entity entity1, entt::entity entity2) {
+  auto [it, isInserted] = contacts.try_emplace(pairKey(entity1, entity2));
+
+  Contact& contact = it->second;
+  if (isInserted) {
+    contact.entity1 = entity1;
+    contact.entity2 = entity2;
+    contact.firstStep = step;
+  }
+
+  contact.lastStep = step;
+  return contact;
+}
+
+bool plugins::physics::ContactCache::isNew(const Contact& contact) const noexcept {
+  return contact.firstStep == step;
+}
+
+/* clang-format off */
+std::vector<plugins::physics::Contact> plugins::physics::ContactCache::endStep(
+  const std::function<bool(const Contact&)>& shouldKeep
+) { /* clang-format on */
+  std::vector<Contact> ended;
+
+  for (auto it = contacts.begin(); it != contacts.end();) {
+    if (it->second.lastStep == step || shouldKeep(it->second)) {
+      ++it;
+      continue;
+    }
+
+    ended.push_back(it->second);
+    it = contacts.erase(it);
+  }
+
+  // Map order depends on hashing, callbacks shouldn't
+  std::sort(ended.begin(), ended.end(), [](const Contact& a, const Contact& b) {
+    return pairKey(a.entity1, a.entity2) < pairKey(b.entity1, b.entity2);
+  });
+
+  return ended;
+}
+
+size_t plugins::physics::ContactCache::size() const noexcept {
+  return contacts.size();
+}
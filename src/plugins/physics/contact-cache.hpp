@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+
+namespace plugins::physics {
+  struct Contact {
+    // entity1 < entity2
+    entt::entity entity1;
+    entt::entity entity2;
+
+    // Points from entity2 towards entity1
+    glm::vec3 normal;
+    float depth;
+
+    // Total impulse the solver applied along the normal, carried into the next step to warm start it
+    float normalImpulse = 0.0f;
+
+    uint64_t firstStep = 0;
+    uint64_t lastStep = 0;
+  };
+
+  // Contacts keyed by entity pair, kept alive across steps for as long as the pair keeps touching.
+  // This is what tells a collision starting (enter) apart from one continuing (stay) or ending (exit).
+  class ContactCache {
+  public:
+    void beginStep() noexcept;
+
+    // Finds or creates the contact between two entities (entity1 < entity2), and marks it as touching this step.
+    // References stay valid until endStep.
+    Contact& touch(entt::entity entity1, entt::entity entity2);
+
+    [[nodiscard]] bool isNew(const Contact& contact) const noexcept;
+
+    // Drops every contact that wasn't touched this step and isn't kept alive by shouldKeep (eg. between sleeping
+    // bodies, which aren't tested at all), returning them in a deterministic order
+    [[nodiscard]] std::vector<Contact> endStep(const std::function<bool(const Contact&)>& shouldKeep);
+
+    [[nodiscard]] size_t size() const noexcept;
+
+  private:
+    std::unordered_map<uint64_t, Contact> contacts;
+    uint64_t step = 0;
+  };
+};
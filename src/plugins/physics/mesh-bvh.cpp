@@ -0,0 +1,702 @@
+#include "mesh-bvh.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <print>
+#include <utility>
+
+static constexpr uint32_t BIN_COUNT = 16;
+
+// Cost of visiting a node relative to testing one triangle
+static constexpr float TRAVERSAL_COST = 1.0f;
+
+// Levels split on the calling thread before every remaining subtree becomes its own task. Fixed rather than based on
+// the thread count, so the node layout (and the cache) comes out the same everywhere.
+static constexpr uint32_t PARALLEL_DEPTH = 6;
+
+// Triangles per task when a single node is big enough to be worth binning from the pool
+static constexpr size_t TRIANGLES_PER_CHUNK = 16384;
+
+static constexpr uint32_t CACHE_MAGIC = 0x48564251; // "QBVH"
+static constexpr uint32_t CACHE_VERSION = 1;
+
+static constexpr plugins::physics::Aabb EMPTY_BOUNDS = {/* clang-format off */
+  .min = glm::vec3(std::numeric_limits<float>::max()),
+  .max = glm::vec3(std::numeric_limits<float>::lowest())
+}; /* clang-format on */
+
+static plugins::physics::Aabb growBounds(const plugins::physics::Aabb& bounds, const glm::vec3& point) noexcept {
+  return {.min = glm::min(bounds.min, point), .max = glm::max(bounds.max, point)};
+}
+
+struct plugins::physics::MeshBvh::Builder {
+  struct Bin {
+    Aabb bounds = EMPTY_BOUNDS;
+    uint32_t count = 0;
+  };
+  using Bins = std::array<std::array<Bin, BIN_COUNT>, 3>;
+
+  util::ThreadPool& pool;
+
+  std::vector<Aabb> triangleBounds;
+  std::vector<glm::vec3> centroids;
+
+  // Triangle indices, partitioned in place as the tree is built. Every node covers a contiguous range of it.
+  std::vector<uint32_t> order;
+
+  Builder(const std::vector<Triangle>& triangles, util::ThreadPool& pool) : pool(pool) {
+    triangleBounds.resize(triangles.size());
+    centroids.resize(triangles.size());
+    order.resize(triangles.size());
+
+    pool.parallelFor(triangles.size(), TRIANGLES_PER_CHUNK, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const auto& triangle = triangles[i];
+        triangleBounds[i] = {/* clang-format off */
+          .min = glm::min(triangle.v0, glm::min(triangle.v1, triangle.v2)),
+          .max = glm::max(triangle.v0, glm::max(triangle.v1, triangle.v2))
+        }; /* clang-format on */
+        centroids[i] = (triangleBounds[i].min + triangleBounds[i].max) * 0.5f;
+        order[i] = static_cast<uint32_t>(i);
+      }
+    });
+  }
+
+  // Folds fn(begin, end, partial) over order[first, first + count), from the pool only if there's enough of it.
+  // Partial results are merged in chunk order, so the result doesn't depend on which thread ran what.
+  template <typename T, typename Fn, typename Merge>
+  T reduce(uint32_t first, uint32_t count, const T& initial, Fn&& fn, Merge&& merge) {
+    if (count < TRIANGLES_PER_CHUNK * 2) {
+      T result = initial;
+      fn(first, first + count, result);
+      return result;
+    }
+
+    std::vector<T> partials((count + TRIANGLES_PER_CHUNK - 1) / TRIANGLES_PER_CHUNK, initial);
+    pool.parallelFor(count, TRIANGLES_PER_CHUNK, [&](size_t begin, size_t end) {
+      fn(first + begin, first + end, partials[begin / TRIANGLES_PER_CHUNK]);
+    });
+
+    T result = partials[0];
+    for (size_t i = 1; i < partials.size(); ++i) {
+      merge(result, partials[i]);
+    }
+    return result;
+  }
+
+  // Fills in the node's bounds, and either makes it a leaf or partitions its triangles and gives it two children
+  // (appended to nodes). Returns how many triangles went to the first child, nothing for leaves.
+  std::optional<uint32_t> makeNode(std::vector<Node>& nodes, uint32_t nodeIdx, uint32_t first, uint32_t count) {
+    // Triangle bounds, and the bounds of their centroids
+    using BoundsPair = std::pair<Aabb, Aabb>;
+    auto [bounds, centroidBounds] = reduce(/* clang-format off */
+      first, count, BoundsPair{EMPTY_BOUNDS, EMPTY_BOUNDS},
+      [&](size_t begin, size_t end, BoundsPair& partial) {
+        for (size_t i = begin; i < end; ++i) {
+          partial.first = partial.first.merge(triangleBounds[order[i]]);
+          partial.second = growBounds(partial.second, centroids[order[i]]);
+        }
+      },
+      [](BoundsPair& result, const BoundsPair& partial) {
+        result.first = result.first.merge(partial.first);
+        result.second = result.second.merge(partial.second);
+      }
+    ); /* clang-format on */
+
+    nodes[nodeIdx].min = bounds.min;
+    nodes[nodeIdx].max = bounds.max;
+
+    auto makeLeaf = [&]() -> std::optional<uint32_t> {
+      nodes[nodeIdx].firstIdx = first;
+      nodes[nodeIdx].triangleCount = count;
+      return std::nullopt;
+    };
+
+    auto makeInner = [&](uint32_t leftCount) -> std::optional<uint32_t> {
+      uint32_t childIdx = static_cast<uint32_t>(nodes.size());
+      nodes.resize(nodes.size() + 2);
+      nodes[nodeIdx].firstIdx = childIdx;
+      nodes[nodeIdx].triangleCount = 0;
+      return leftCount;
+    };
+
+    if (count <= 1) {
+      return makeLeaf();
+    }
+
+    glm::vec3 extent = centroidBounds.max - centroidBounds.min;
+    if (extent.x <= 0.0f && extent.y <= 0.0f && extent.z <= 0.0f) {
+      // Every centroid in the same spot, no plane can separate them
+      return count <= MAX_LEAF_TRIANGLES ? makeLeaf() : makeInner(count / 2);
+    }
+
+    glm::vec3 binScale = glm::vec3(static_cast<float>(BIN_COUNT)) / glm::max(extent, glm::vec3(1e-30f));
+    auto binOf = [&](uint32_t triangleIdx, int axis) {
+      float offset = (centroids[triangleIdx][axis] - centroidBounds.min[axis]) * binScale[axis];
+      return std::min(static_cast<uint32_t>(std::max(offset, 0.0f)), BIN_COUNT - 1);
+    };
+
+    Bins bins = reduce(/* clang-format off */
+      first, count, Bins{},
+      [&](size_t begin, size_t end, Bins& partial) {
+        for (size_t i = begin; i < end; ++i) {
+          uint32_t triangleIdx = order[i];
+          for (int axis = 0; axis < 3; ++axis) {
+            auto& bin = partial[axis][binOf(triangleIdx, axis)];
+            bin.bounds = bin.bounds.merge(triangleBounds[triangleIdx]);
+            bin.count++;
+          }
+        }
+      },
+      [](Bins& result, const Bins& partial) {
+        for (int axis = 0; axis < 3; ++axis) {
+          for (uint32_t i = 0; i < BIN_COUNT; ++i) {
+            result[axis][i].bounds = result[axis][i].bounds.merge(partial[axis][i].bounds);
+            result[axis][i].count += partial[axis][i].count;
+          }
+        }
+      }
+    ); /* clang-format on */
+
+    // Cost of every plane between bins, sweeping in from both ends
+    float bestCost = std::numeric_limits<float>::max();
+    int bestAxis = -1;
+    uint32_t bestPlane = 0;
+
+    for (int axis = 0; axis < 3; ++axis) {
+      if (extent[axis] <= 0.0f) {
+        continue;
+      }
+
+      std::array<float, BIN_COUNT> leftCosts;
+      Aabb leftBounds = EMPTY_BOUNDS;
+      uint32_t leftCount = 0;
+      for (uint32_t plane = 1; plane < BIN_COUNT; ++plane) {
+        leftBounds = leftBounds.merge(bins[axis][plane - 1].bounds);
+        leftCount += bins[axis][plane - 1].count;
+        leftCosts[plane] = leftCount > 0 ? leftBounds.surfaceArea() * static_cast<float>(leftCount) : 0.0f;
+      }
+
+      Aabb rightBounds = EMPTY_BOUNDS;
+      uint32_t rightCount = 0;
+      for (uint32_t plane = BIN_COUNT - 1; plane > 0; --plane) {
+        rightBounds = rightBounds.merge(bins[axis][plane].bounds);
+        rightCount += bins[axis][plane].count;
+
+        if (rightCount == 0 || rightCount == count) {
+          continue;
+        }
+
+        float cost = leftCosts[plane] + rightBounds.surfaceArea() * static_cast<float>(rightCount);
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestAxis = axis;
+          bestPlane = plane;
+        }
+      }
+    }
+
+    float leafCost = static_cast<float>(count);
+    float splitCost = TRAVERSAL_COST + bestCost / std::max(bounds.surfaceArea(), 1e-30f);
+    if (count <= MAX_LEAF_TRIANGLES && (bestAxis < 0 || splitCost >= leafCost)) {
+      return makeLeaf();
+    }
+
+    if (bestAxis < 0) {
+      return makeInner(count / 2);
+    }
+
+    auto begin = order.begin() + first;
+    auto middle = std::partition(begin, begin + count, [&](uint32_t triangleIdx) {
+      return binOf(triangleIdx, bestAxis) < bestPlane;
+    });
+
+    return makeInner(static_cast<uint32_t>(middle - begin));
+  }
+
+  // Builds the whole subtree under nodeIdx
+  void buildSubtree(std::vector<Node>& nodes, uint32_t nodeIdx, uint32_t first, uint32_t count) {
+    struct Range {
+      uint32_t nodeIdx;
+      uint32_t first;
+      uint32_t count;
+    };
+
+    // Explicit stack, lopsided splits can make for deep trees
+    std::vector<Range> stack = {{nodeIdx, first, count}};
+    while (!stack.empty()) {
+      Range range = stack.back();
+      stack.pop_back();
+
+      auto leftCount = makeNode(nodes, range.nodeIdx, range.first, range.count);
+      if (!leftCount) {
+        continue;
+      }
+
+      uint32_t childIdx = nodes[range.nodeIdx].firstIdx;
+      stack.push_back({childIdx + 1, range.first + *leftCount, range.count - *leftCount});
+      stack.push_back({childIdx, range.first, *leftCount});
+    }
+  }
+};
+
+std::vector<plugins::physics::Triangle> plugins::physics::MeshBvh::trianglesFromAsset(const asset::Asset3D& asset) {
+  std::vector<Triangle> triangles;
+
+  auto isValid = [&asset](int index) {
+    return index >= 0 && static_cast<size_t>(index) < asset.vertices.size();
+  };
+
+  for (const auto& node : asset.nodes) {
+    for (const auto& group : node.groups) {
+      for (size_t i = 0; i + 2 < group.indices.size(); i += 3) {
+        int i0 = group.indices[i];
+        int i1 = group.indices[i + 1];
+        int i2 = group.indices[i + 2];
+        if (!isValid(i0) || !isValid(i1) || !isValid(i2)) {
+          continue;
+        }
+
+        triangles.push_back({asset.vertices[i0].pos, asset.vertices[i1].pos, asset.vertices[i2].pos});
+      }
+    }
+  }
+
+  return triangles;
+}
+
+/* clang-format off */
+plugins::physics::MeshBvh plugins::physics::MeshBvh::build(
+  std::vector<Triangle> triangles,
+  util::ThreadPool& pool
+) { /* clang-format on */
+  MeshBvh bvh;
+  bvh.sourceHash = hashTriangles(triangles);
+
+  if (triangles.empty()) {
+    return bvh;
+  }
+
+  Builder builder(triangles, pool);
+
+  struct Subtree {
+    uint32_t nodeIdx;
+    uint32_t first;
+    uint32_t count;
+
+    // Local root first
+    std::vector<Node> nodes;
+  };
+  std::vector<Subtree> subtrees;
+
+  // Top levels on this thread, binning big nodes from the pool
+  std::vector<std::pair<Subtree, uint32_t>> stack = {{{0, 0, static_cast<uint32_t>(triangles.size()), {}}, 0}};
+  bvh.nodes.resize(1);
+
+  while (!stack.empty()) {
+    auto [subtree, depth] = std::move(stack.back());
+    stack.pop_back();
+
+    if (depth == PARALLEL_DEPTH) {
+      subtrees.push_back(std::move(subtree));
+      continue;
+    }
+
+    auto leftCount = builder.makeNode(bvh.nodes, subtree.nodeIdx, subtree.first, subtree.count);
+    if (!leftCount) {
+      continue;
+    }
+
+    uint32_t childIdx = bvh.nodes[subtree.nodeIdx].firstIdx;
+    stack.push_back({{childIdx + 1, subtree.first + *leftCount, subtree.count - *leftCount, {}}, depth + 1});
+    stack.push_back({{childIdx, subtree.first, *leftCount, {}}, depth + 1});
+  }
+
+  pool.parallelFor(subtrees.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      auto& subtree = subtrees[i];
+      subtree.nodes.resize(1);
+      builder.buildSubtree(subtree.nodes, 0, subtree.first, subtree.count);
+    }
+  });
+
+  // Stitch every subtree in, in the order they were split off. Local node i > 0 lands at base + i - 1, and the local
+  // root replaces the placeholder left for it.
+  for (auto& subtree : subtrees) {
+    uint32_t base = static_cast<uint32_t>(bvh.nodes.size());
+
+    for (auto& node : subtree.nodes) {
+      if (!node.isLeaf()) {
+        node.firstIdx = base + node.firstIdx - 1;
+      }
+    }
+
+    bvh.nodes[subtree.nodeIdx] = subtree.nodes[0];
+    bvh.nodes.insert(bvh.nodes.end(), subtree.nodes.begin() + 1, subtree.nodes.end());
+  }
+
+  bvh.triangles.resize(triangles.size());
+  for (size_t i = 0; i < triangles.size(); ++i) {
+    bvh.triangles[i] = triangles[builder.order[i]];
+  }
+  bvh.triangleOrder = std::move(builder.order);
+
+  return bvh;
+}
+
+uint64_t plugins::physics::MeshBvh::hashTriangles(const std::vector<Triangle>& triangles) noexcept {
+  // FNV-1a over the raw vertex data
+  uint64_t hash = 0xcbf29ce484222325ull;
+
+  const auto* bytes = reinterpret_cast<const unsigned char*>(triangles.data());
+  for (size_t i = 0; i < triangles.size() * sizeof(Triangle); ++i) {
+    hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+  }
+
+  return hash;
+}
+
+/* clang-format off */
+std::expected<plugins::physics::MeshBvh, std::string> plugins::physics::MeshBvh::tryFromCache(
+  const std::filesystem::path& path,
+  std::vector<Triangle> triangles
+) { /* clang-format on */
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return std::unexpected{std::format("Failed to open {}", path.string())};
+  }
+
+  uint32_t magic = 0;
+  uint32_t version = 0;
+  uint64_t hash = 0;
+  uint64_t nodeCount = 0;
+  uint64_t triangleCount = 0;
+
+  file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+  file.read(reinterpret_cast<char*>(&version), sizeof(version));
+  file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+  file.read(reinterpret_cast<char*>(&nodeCount), sizeof(nodeCount));
+  file.read(reinterpret_cast<char*>(&triangleCount), sizeof(triangleCount));
+
+  if (!file || magic != CACHE_MAGIC || version != CACHE_VERSION) {
+    return std::unexpected{std::format("{} isn't a BVH cache of this version", path.string())};
+  }
+
+  if (hash != hashTriangles(triangles) || triangleCount != triangles.size()) {
+    return std::unexpected{std::format("{} was built from a different mesh", path.string())};
+  }
+
+  // A node per triangle is already more than SAH ever makes
+  if (nodeCount > std::max<uint64_t>(triangleCount * 2, 1)) {
+    return std::unexpected{std::format("{} is corrupt", path.string())};
+  }
+
+  MeshBvh bvh;
+  bvh.sourceHash = hash;
+  bvh.nodes.resize(nodeCount);
+  bvh.triangleOrder.resize(triangleCount);
+
+  file.read(reinterpret_cast<char*>(bvh.nodes.data()), static_cast<std::streamsize>(nodeCount * sizeof(Node)));
+  file.read(/* clang-format off */
+    reinterpret_cast<char*>(bvh.triangleOrder.data()),
+    static_cast<std::streamsize>(triangleCount * sizeof(uint32_t))
+  ); /* clang-format on */
+
+  if (!file) {
+    return std::unexpected{std::format("{} is truncated", path.string())};
+  }
+
+  // Don't trust indices from disk. Children always come after their parent, which also rules out a child pointing back
+  // up the tree and sending traversal round in circles.
+  for (size_t nodeIdx = 0; nodeIdx < bvh.nodes.size(); ++nodeIdx) {
+    const auto& node = bvh.nodes[nodeIdx];
+    bool isInRange = node.isLeaf() ? /* clang-format off */
+      static_cast<uint64_t>(node.firstIdx) + node.triangleCount <= triangleCount :
+      node.firstIdx > nodeIdx && static_cast<uint64_t>(node.firstIdx) + 1 < nodeCount; /* clang-format on */
+
+    if (!isInRange) {
+      return std::unexpected{std::format("{} is corrupt", path.string())};
+    }
+  }
+
+  bvh.triangles.resize(triangleCount);
+  for (size_t i = 0; i < triangleCount; ++i) {
+    if (bvh.triangleOrder[i] >= triangleCount) {
+      return std::unexpected{std::format("{} is corrupt", path.string())};
+    }
+
+    bvh.triangles[i] = triangles[bvh.triangleOrder[i]];
+  }
+
+  return bvh;
+}
+
+std::expected<void, std::string> plugins::physics::MeshBvh::trySaveCache(const std::filesystem::path& path) const {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    return std::unexpected{std::format("Failed to open {}", path.string())};
+  }
+
+  uint64_t nodeCount = nodes.size();
+  uint64_t triangleCount = triangles.size();
+
+  file.write(reinterpret_cast<const char*>(&CACHE_MAGIC), sizeof(CACHE_MAGIC));
+  file.write(reinterpret_cast<const char*>(&CACHE_VERSION), sizeof(CACHE_VERSION));
+  file.write(reinterpret_cast<const char*>(&sourceHash), sizeof(sourceHash));
+  file.write(reinterpret_cast<const char*>(&nodeCount), sizeof(nodeCount));
+  file.write(reinterpret_cast<const char*>(&triangleCount), sizeof(triangleCount));
+  file.write(reinterpret_cast<const char*>(nodes.data()), static_cast<std::streamsize>(nodeCount * sizeof(Node)));
+  file.write(/* clang-format off */
+    reinterpret_cast<const char*>(triangleOrder.data()),
+    static_cast<std::streamsize>(triangleCount * sizeof(uint32_t))
+  ); /* clang-format on */
+
+  if (!file) {
+    return std::unexpected{std::format("Failed to write {}", path.string())};
+  }
+
+  return {};
+}
+
+/* clang-format off */
+plugins::physics::MeshBvh plugins::physics::MeshBvh::fromAsset(
+  const asset::Asset3D& asset,
+  util::ThreadPool& pool,
+  const std::filesystem::path& cachePath
+) { /* clang-format on */
+  auto triangles = trianglesFromAsset(asset);
+
+  auto cached = tryFromCache(cachePath, triangles);
+  if (cached.has_value()) {
+    return std::move(cached.value());
+  }
+
+  std::println("Building collision mesh for {} ({})", asset.path.string(), cached.error());
+  MeshBvh bvh = build(std::move(triangles), pool);
+
+  if (auto result = bvh.trySaveCache(cachePath); !result.has_value()) {
+    std::println(stderr, "Failed to cache collision mesh: {}", result.error());
+  }
+
+  return bvh;
+}
+
+// Distance along the ray to where it enters the box, or infinity if it misses within maxDistance
+/* clang-format off */
+static float rayBoxDistance(
+  const glm::vec3& origin,
+  const glm::vec3& inverseDirection,
+  const plugins::physics::Aabb& bounds,
+  float maxDistance
+) { /* clang-format on */
+  glm::vec3 t1 = (bounds.min - origin) * inverseDirection;
+  glm::vec3 t2 = (bounds.max - origin) * inverseDirection;
+
+  glm::vec3 tMin = glm::min(t1, t2);
+  glm::vec3 tMax = glm::max(t1, t2);
+
+  float entry = std::max(std::max(tMin.x, tMin.y), std::max(tMin.z, 0.0f));
+  float exit = std::min(std::min(tMax.x, tMax.y), std::min(tMax.z, maxDistance));
+
+  return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+}
+
+// Möller-Trumbore, hitting either side
+/* clang-format off */
+static std::optional<float> rayTriangleDistance(
+  const glm::vec3& origin,
+  const glm::vec3& direction,
+  const plugins::physics::Triangle& triangle
+) { /* clang-format on */
+  glm::vec3 edge1 = triangle.v1 - triangle.v0;
+  glm::vec3 edge2 = triangle.v2 - triangle.v0;
+
+  glm::vec3 p = glm::cross(direction, edge2);
+  float determinant = glm::dot(edge1, p);
+  if (std::abs(determinant) < 1e-12f) {
+    return std::nullopt;
+  }
+
+  float inverseDeterminant = 1.0f / determinant;
+  glm::vec3 s = origin - triangle.v0;
+
+  float u = glm::dot(s, p) * inverseDeterminant;
+  if (u < 0.0f || u > 1.0f) {
+    return std::nullopt;
+  }
+
+  glm::vec3 q = glm::cross(s, edge1);
+  float v = glm::dot(direction, q) * inverseDeterminant;
+  if (v < 0.0f || u + v > 1.0f) {
+    return std::nullopt;
+  }
+
+  float distance = glm::dot(edge2, q) * inverseDeterminant;
+  return distance >= 0.0f ? std::optional(distance) : std::nullopt;
+}
+
+/* clang-format off */
+std::optional<plugins::physics::MeshRaycastHit> plugins::physics::MeshBvh::raycast(
+  const glm::vec3& origin,
+  const glm::vec3& direction,
+  float maxDistance
+) const { /* clang-format on */
+  if (nodes.empty()) {
+    return std::nullopt;
+  }
+
+  glm::vec3 inverseDirection = 1.0f / direction;
+
+  std::optional<MeshRaycastHit> closest;
+  float closestDistance = maxDistance;
+
+  std::vector<uint32_t> stack;
+  stack.reserve(64);
+  stack.push_back(0);
+
+  while (!stack.empty()) {
+    const Node& node = nodes[stack.back()];
+    stack.pop_back();
+
+    if (rayBoxDistance(origin, inverseDirection, node.getBounds(), closestDistance) > closestDistance) {
+      continue;
+    }
+
+    if (node.isLeaf()) {
+      for (uint32_t i = node.firstIdx; i < node.firstIdx + node.triangleCount; ++i) {
+        auto distance = rayTriangleDistance(origin, direction, triangles[i]);
+        if (!distance || *distance > closestDistance) {
+          continue;
+        }
+
+        const auto& triangle = triangles[i];
+        glm::vec3 normal = glm::normalize(glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0));
+
+        closestDistance = *distance;
+        closest = MeshRaycastHit{/* clang-format off */
+          .distance = *distance,
+          .point = origin + direction * *distance,
+          .normal = glm::dot(normal, direction) > 0.0f ? -normal : normal,
+          .triangleIdx = i
+        }; /* clang-format on */
+      }
+      continue;
+    }
+
+    // Nearer child last so it's popped first, and its hits can cull the other one
+    float distance1 = rayBoxDistance(origin, inverseDirection, nodes[node.firstIdx].getBounds(), closestDistance);
+    float distance2 = rayBoxDistance(origin, inverseDirection, nodes[node.firstIdx + 1].getBounds(), closestDistance);
+
+    if (distance1 <= distance2) {
+      stack.push_back(node.firstIdx + 1);
+      stack.push_back(node.firstIdx);
+    } else {
+      stack.push_back(node.firstIdx);
+      stack.push_back(node.firstIdx + 1);
+    }
+  }
+
+  return closest;
+}
+
+// Separating axis test between a box and a triangle: the box's axes, the triangle's normal, and the 9 cross products
+// of their edges
+/* clang-format off */
+static bool boxOverlapsTriangle(
+  const glm::vec3& center,
+  const glm::vec3& halfExtents,
+  const plugins::physics::Triangle& triangle
+) { /* clang-format on */
+  glm::vec3 v0 = triangle.v0 - center;
+  glm::vec3 v1 = triangle.v1 - center;
+  glm::vec3 v2 = triangle.v2 - center;
+
+  if (/* clang-format off */
+    std::min({v0.x, v1.x, v2.x}) > halfExtents.x || std::max({v0.x, v1.x, v2.x}) < -halfExtents.x ||
+    std::min({v0.y, v1.y, v2.y}) > halfExtents.y || std::max({v0.y, v1.y, v2.y}) < -halfExtents.y ||
+    std::min({v0.z, v1.z, v2.z}) > halfExtents.z || std::max({v0.z, v1.z, v2.z}) < -halfExtents.z
+  ) { /* clang-format on */
+    return false;
+  }
+
+  auto isSeparating = [&](const glm::vec3& axis) {
+    float p0 = glm::dot(v0, axis);
+    float p1 = glm::dot(v1, axis);
+    float p2 = glm::dot(v2, axis);
+    float radius = glm::dot(halfExtents, glm::abs(axis));
+
+    return std::min({p0, p1, p2}) > radius || std::max({p0, p1, p2}) < -radius;
+  };
+
+  std::array<glm::vec3, 3> edges = {v1 - v0, v2 - v1, v0 - v2};
+  if (isSeparating(glm::cross(edges[0], edges[1]))) {
+    return false;
+  }
+
+  for (const auto& edge : edges) {
+    /* clang-format off */
+    if (
+      isSeparating(glm::vec3(0.0f, -edge.z, edge.y)) ||
+      isSeparating(glm::vec3(edge.z, 0.0f, -edge.x)) ||
+      isSeparating(glm::vec3(-edge.y, edge.x, 0.0f))
+    ) { /* clang-format on */
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool plugins::physics::MeshBvh::collideBox(const Aabb& box, glm::vec3& penetrationDepth) const {
+  glm::vec3 center = (box.min + box.max) * 0.5f;
+  glm::vec3 halfExtents = (box.max - box.min) * 0.5f;
+
+  bool isColliding = false;
+  float deepest = 0.0f;
+
+  query(box, [&](uint32_t triangleIdx) {
+    const auto& triangle = triangles[triangleIdx];
+
+    glm::vec3 normal = glm::cross(triangle.v1 - triangle.v0, triangle.v2 - triangle.v0);
+    float length = glm::length(normal);
+    if (length == 0.0f || !boxOverlapsTriangle(center, halfExtents, triangle)) {
+      return true;
+    }
+    normal /= length;
+
+    // Out whichever side the box's centre is on, level geometry isn't always wound consistently
+    float distance = glm::dot(normal, center - triangle.v0);
+    float depth = glm::dot(halfExtents, glm::abs(normal)) - std::abs(distance);
+
+    // The overlap test counts touching as overlapping, but that leaves nothing to push out along
+    if (depth <= 0.0f) {
+      return true;
+    }
+
+    if (!isColliding || depth > deepest) {
+      isColliding = true;
+      deepest = depth;
+      penetrationDepth = (distance < 0.0f ? -normal : normal) * depth;
+    }
+
+    return true;
+  });
+
+  return isColliding;
+}
+
+const std::vector<plugins::physics::Triangle>& plugins::physics::MeshBvh::getTriangles() const noexcept {
+  return triangles;
+}
+
+plugins::physics::Aabb plugins::physics::MeshBvh::getBounds() const noexcept {
+  return nodes.empty() ? Aabb{.min = glm::vec3(0.0f), .max = glm::vec3(0.0f)} : nodes[0].getBounds();
+}
+
+size_t plugins::physics::MeshBvh::getNodeCount() const noexcept {
+  return nodes.size();
+}
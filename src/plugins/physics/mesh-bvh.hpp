@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aabb.hpp"
+#include "asset/asset.hpp"
+#include "util/thread-pool.hpp"
+
+namespace plugins::physics {
+  struct Triangle {
+    glm::vec3 v0;
+    glm::vec3 v1;
+    glm::vec3 v2;
+  };
+
+  struct MeshRaycastHit {
+    float distance;
+    glm::vec3 point;
+    glm::vec3 normal;
+    uint32_t triangleIdx;
+  };
+
+  // Static bounding volume hierarchy over a triangle mesh, for colliding against level geometry.
+  //
+  // Built once, top-down, by binning triangle centroids and splitting where the surface area heuristic says a ray or
+  // box is least likely to have to visit both sides. Nodes are flattened into one array with siblings next to each
+  // other, 32 bytes each, and triangles are reordered so every leaf's are contiguous.
+  class MeshBvh {
+  public:
+    static constexpr uint32_t MAX_LEAF_TRIANGLES = 4;
+
+    // Every triangle of the asset, in asset space
+    [[nodiscard]] static std::vector<Triangle> trianglesFromAsset(const asset::Asset3D& asset);
+
+    // The top of the tree is split on the calling thread, then every subtree below it is built from the pool.
+    // The result doesn't depend on the thread count.
+    [[nodiscard]] static MeshBvh build(std::vector<Triangle> triangles, util::ThreadPool& pool);
+
+    // Loads a tree written by trySaveCache, as long as it was built from these same triangles
+    /* clang-format off */
+    [[nodiscard]] static std::expected<MeshBvh, std::string> tryFromCache(
+      const std::filesystem::path& path,
+      std::vector<Triangle> triangles
+    ); /* clang-format on */
+
+    [[nodiscard]] std::expected<void, std::string> trySaveCache(const std::filesystem::path& path) const;
+
+    // Loads the tree cached at cachePath if it's still up to date, otherwise builds it and rewrites the cache
+    /* clang-format off */
+    [[nodiscard]] static MeshBvh fromAsset(
+      const asset::Asset3D& asset,
+      util::ThreadPool& pool,
+      const std::filesystem::path& cachePath
+    ); /* clang-format on */
+
+    // Calls fn(triangleIdx) for every triangle in a leaf whose box overlaps bounds, until it returns false
+    template <typename Fn> void query(const Aabb& bounds, Fn&& fn) const;
+
+    // Closest triangle hit by the ray, from either side, if any within maxDistance. direction must be normalized.
+    /* clang-format off */
+    [[nodiscard]] std::optional<MeshRaycastHit> raycast(
+      const glm::vec3& origin,
+      const glm::vec3& direction,
+      float maxDistance
+    ) const; /* clang-format on */
+
+    // Whether the box penetrates any triangle, just touching doesn't count. penetrationDepth is set to what pushes the
+    // box out of the deepest one, along that triangle's normal.
+    [[nodiscard]] bool collideBox(const Aabb& box, glm::vec3& penetrationDepth) const;
+
+    [[nodiscard]] const std::vector<Triangle>& getTriangles() const noexcept;
+    [[nodiscard]] Aabb getBounds() const noexcept;
+    [[nodiscard]] size_t getNodeCount() const noexcept;
+
+  private:
+    struct Node {
+      glm::vec3 min;
+
+      // First triangle for leaves, first child for inner nodes (the second one comes right after it)
+      uint32_t firstIdx;
+
+      glm::vec3 max;
+
+      // 0 for inner nodes
+      uint32_t triangleCount;
+
+      [[nodiscard]] bool isLeaf() const noexcept {
+        return triangleCount > 0;
+      }
+
+      [[nodiscard]] Aabb getBounds() const noexcept {
+        return {.min = min, .max = max};
+      }
+    };
+    static_assert(sizeof(Node) == 32);
+
+    // Scratch state while building, see mesh-bvh.cpp
+    struct Builder;
+
+    // What the triangles hash to, to tell a stale cache apart
+    [[nodiscard]] static uint64_t hashTriangles(const std::vector<Triangle>& triangles) noexcept;
+
+    std::vector<Node> nodes;
+    std::vector<Triangle> triangles;
+
+    // Original index of every triangle, in leaf order
+    std::vector<uint32_t> triangleOrder;
+    uint64_t sourceHash = 0;
+  };
+
+  template <typename Fn> void MeshBvh::query(const Aabb& bounds, Fn&& fn) const {
+    if (nodes.empty()) {
+      return;
+    }
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(0);
+
+    while (!stack.empty()) {
+      const Node& node = nodes[stack.back()];
+      stack.pop_back();
+
+      if (!node.getBounds().overlaps(bounds)) {
+        continue;
+      }
+
+      if (!node.isLeaf()) {
+        stack.push_back(node.firstIdx);
+        stack.push_back(node.firstIdx + 1);
+        continue;
+      }
+
+      for (uint32_t i = node.firstIdx; i < node.firstIdx + node.triangleCount; ++i) {
+        if (!fn(i)) {
+          return;
+        }
+      }
+    }
+  }
+};
@@ -0,0 +1,212 @@
+#include "narrowphase.hpp"
+
+#include <cmath>
+
+#include "util/cpu.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define QUN_NARROWPHASE_X86
+  #include <immintrin.h>
+#endif
+
+void plugins::physics::BoxPairBatch::resize(size_t count) {
+  for (auto* values : {&positionX1, &positionY1, &positionZ1, &halfExtentsX1, &halfExtentsY1, &halfExtentsZ1,
+                       &positionX2, &positionY2, &positionZ2, &halfExtentsX2, &halfExtentsY2, &halfExtentsZ2,
+                       &penetrationX, &penetrationY, &penetrationZ}) {
+    values->resize(count);
+  }
+
+  isColliding.resize(count);
+}
+
+void plugins::physics::BoxPairBatch::set(size_t idx, const glm::vec3& pos1, const glm::vec3& halfExtents1,
+                                         const glm::vec3& pos2, const glm::vec3& halfExtents2) {
+  positionX1[idx] = pos1.x;
+  positionY1[idx] = pos1.y;
+  positionZ1[idx] = pos1.z;
+
+  halfExtentsX1[idx] = halfExtents1.x;
+  halfExtentsY1[idx] = halfExtents1.y;
+  halfExtentsZ1[idx] = halfExtents1.z;
+
+  positionX2[idx] = pos2.x;
+  positionY2[idx] = pos2.y;
+  positionZ2[idx] = pos2.z;
+
+  halfExtentsX2[idx] = halfExtents2.x;
+  halfExtentsY2[idx] = halfExtents2.y;
+  halfExtentsZ2[idx] = halfExtents2.z;
+}
+
+glm::vec3 plugins::physics::BoxPairBatch::getPenetrationDepth(size_t idx) const noexcept {
+  return {penetrationX[idx], penetrationY[idx], penetrationZ[idx]};
+}
+
+size_t plugins::physics::BoxPairBatch::size() const noexcept {
+  return positionX1.size();
+}
+
+void plugins::physics::testBoxPairsScalar(BoxPairBatch& batch, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    glm::vec3 distance = /* clang-format off */
+      glm::vec3(batch.positionX1[i], batch.positionY1[i], batch.positionZ1[i]) -
+      glm::vec3(batch.positionX2[i], batch.positionY2[i], batch.positionZ2[i]);
+    glm::vec3 totalHalfExtents =
+      glm::vec3(batch.halfExtentsX1[i], batch.halfExtentsY1[i], batch.halfExtentsZ1[i]) +
+      glm::vec3(batch.halfExtentsX2[i], batch.halfExtentsY2[i], batch.halfExtentsZ2[i]); /* clang-format on */
+
+    glm::vec3 overlap = totalHalfExtents - glm::abs(distance);
+    glm::vec3 penetrationDepth(0.0f);
+
+    bool isColliding = overlap.x > 0.0f && overlap.y > 0.0f && overlap.z > 0.0f;
+    if (isColliding) {
+      if (overlap.x <= overlap.y && overlap.x <= overlap.z) {
+        penetrationDepth.x = overlap.x * (distance.x < 0 ? -1.0f : 1.0f);
+      } else if (overlap.y <= overlap.z) {
+        penetrationDepth.y = overlap.y * (distance.y < 0 ? -1.0f : 1.0f);
+      } else {
+        penetrationDepth.z = overlap.z * (distance.z < 0 ? -1.0f : 1.0f);
+      }
+    }
+
+    batch.penetrationX[i] = penetrationDepth.x;
+    batch.penetrationY[i] = penetrationDepth.y;
+    batch.penetrationZ[i] = penetrationDepth.z;
+    batch.isColliding[i] = isColliding;
+  }
+}
+
+#ifdef QUN_NARROWPHASE_X86
+static void testBoxPairsSse(plugins::physics::BoxPairBatch& batch, size_t begin, size_t end) {
+  const __m128 signBit = _mm_set1_ps(-0.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 distanceX = _mm_sub_ps(_mm_loadu_ps(&batch.positionX1[i]), _mm_loadu_ps(&batch.positionX2[i]));
+    __m128 distanceY = _mm_sub_ps(_mm_loadu_ps(&batch.positionY1[i]), _mm_loadu_ps(&batch.positionY2[i]));
+    __m128 distanceZ = _mm_sub_ps(_mm_loadu_ps(&batch.positionZ1[i]), _mm_loadu_ps(&batch.positionZ2[i]));
+
+    __m128 totalX = _mm_add_ps(_mm_loadu_ps(&batch.halfExtentsX1[i]), _mm_loadu_ps(&batch.halfExtentsX2[i]));
+    __m128 totalY = _mm_add_ps(_mm_loadu_ps(&batch.halfExtentsY1[i]), _mm_loadu_ps(&batch.halfExtentsY2[i]));
+    __m128 totalZ = _mm_add_ps(_mm_loadu_ps(&batch.halfExtentsZ1[i]), _mm_loadu_ps(&batch.halfExtentsZ2[i]));
+
+    __m128 overlapX = _mm_sub_ps(totalX, _mm_andnot_ps(signBit, distanceX));
+    __m128 overlapY = _mm_sub_ps(totalY, _mm_andnot_ps(signBit, distanceY));
+    __m128 overlapZ = _mm_sub_ps(totalZ, _mm_andnot_ps(signBit, distanceZ));
+
+    /* clang-format off */
+    __m128 isColliding = _mm_and_ps(
+      _mm_and_ps(_mm_cmpgt_ps(overlapX, zero), _mm_cmpgt_ps(overlapY, zero)),
+      _mm_cmpgt_ps(overlapZ, zero)
+    );
+
+    // Same tie breaking as the scalar path: x, then y, then z
+    __m128 isX = _mm_and_ps(_mm_cmple_ps(overlapX, overlapY), _mm_cmple_ps(overlapX, overlapZ));
+    __m128 isY = _mm_andnot_ps(isX, _mm_cmple_ps(overlapY, overlapZ));
+    __m128 isZ = _mm_andnot_ps(_mm_or_ps(isX, isY), isColliding);
+    isX = _mm_and_ps(isX, isColliding);
+    isY = _mm_and_ps(isY, isColliding);
+
+    // Negating is exact, so flipping the sign bit where distance < 0 matches multiplying by -1
+    __m128 penetrationX = _mm_xor_ps(overlapX, _mm_and_ps(_mm_cmplt_ps(distanceX, zero), signBit));
+    __m128 penetrationY = _mm_xor_ps(overlapY, _mm_and_ps(_mm_cmplt_ps(distanceY, zero), signBit));
+    __m128 penetrationZ = _mm_xor_ps(overlapZ, _mm_and_ps(_mm_cmplt_ps(distanceZ, zero), signBit));
+    /* clang-format on */
+
+    _mm_storeu_ps(&batch.penetrationX[i], _mm_and_ps(isX, penetrationX));
+    _mm_storeu_ps(&batch.penetrationY[i], _mm_and_ps(isY, penetrationY));
+    _mm_storeu_ps(&batch.penetrationZ[i], _mm_and_ps(isZ, penetrationZ));
+
+    int mask = _mm_movemask_ps(isColliding);
+    for (int lane = 0; lane < 4; ++lane) {
+      batch.isColliding[i + lane] = (mask >> lane) & 1;
+    }
+  }
+
+  plugins::physics::testBoxPairsScalar(batch, i, end);
+}
+
+QUN_TARGET_AVX2 static void testBoxPairsAvx2(plugins::physics::BoxPairBatch& batch, size_t begin, size_t end) {
+  const __m256 signBit = _mm256_set1_ps(-0.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 distanceX = _mm256_sub_ps(_mm256_loadu_ps(&batch.positionX1[i]), _mm256_loadu_ps(&batch.positionX2[i]));
+    __m256 distanceY = _mm256_sub_ps(_mm256_loadu_ps(&batch.positionY1[i]), _mm256_loadu_ps(&batch.positionY2[i]));
+    __m256 distanceZ = _mm256_sub_ps(_mm256_loadu_ps(&batch.positionZ1[i]), _mm256_loadu_ps(&batch.positionZ2[i]));
+
+    __m256 totalX = _mm256_add_ps(_mm256_loadu_ps(&batch.halfExtentsX1[i]), _mm256_loadu_ps(&batch.halfExtentsX2[i]));
+    __m256 totalY = _mm256_add_ps(_mm256_loadu_ps(&batch.halfExtentsY1[i]), _mm256_loadu_ps(&batch.halfExtentsY2[i]));
+    __m256 totalZ = _mm256_add_ps(_mm256_loadu_ps(&batch.halfExtentsZ1[i]), _mm256_loadu_ps(&batch.halfExtentsZ2[i]));
+
+    __m256 overlapX = _mm256_sub_ps(totalX, _mm256_andnot_ps(signBit, distanceX));
+    __m256 overlapY = _mm256_sub_ps(totalY, _mm256_andnot_ps(signBit, distanceY));
+    __m256 overlapZ = _mm256_sub_ps(totalZ, _mm256_andnot_ps(signBit, distanceZ));
+
+    /* clang-format off */
+    __m256 isColliding = _mm256_and_ps(
+      _mm256_and_ps(_mm256_cmp_ps(overlapX, zero, _CMP_GT_OQ), _mm256_cmp_ps(overlapY, zero, _CMP_GT_OQ)),
+      _mm256_cmp_ps(overlapZ, zero, _CMP_GT_OQ)
+    );
+
+    // Same tie breaking as the scalar path: x, then y, then z
+    __m256 isX = _mm256_and_ps(
+      _mm256_cmp_ps(overlapX, overlapY, _CMP_LE_OQ),
+      _mm256_cmp_ps(overlapX, overlapZ, _CMP_LE_OQ)
+    );
+    __m256 isY = _mm256_andnot_ps(isX, _mm256_cmp_ps(overlapY, overlapZ, _CMP_LE_OQ));
+    __m256 isZ = _mm256_andnot_ps(_mm256_or_ps(isX, isY), isColliding);
+    isX = _mm256_and_ps(isX, isColliding);
+    isY = _mm256_and_ps(isY, isColliding);
+
+    __m256 penetrationX = _mm256_xor_ps(overlapX, _mm256_and_ps(_mm256_cmp_ps(distanceX, zero, _CMP_LT_OQ), signBit));
+    __m256 penetrationY = _mm256_xor_ps(overlapY, _mm256_and_ps(_mm256_cmp_ps(distanceY, zero, _CMP_LT_OQ), signBit));
+    __m256 penetrationZ = _mm256_xor_ps(overlapZ, _mm256_and_ps(_mm256_cmp_ps(distanceZ, zero, _CMP_LT_OQ), signBit));
+    /* clang-format on */
+
+    _mm256_storeu_ps(&batch.penetrationX[i], _mm256_and_ps(isX, penetrationX));
+    _mm256_storeu_ps(&batch.penetrationY[i], _mm256_and_ps(isY, penetrationY));
+    _mm256_storeu_ps(&batch.penetrationZ[i], _mm256_and_ps(isZ, penetrationZ));
+
+    int mask = _mm256_movemask_ps(isColliding);
+    for (int lane = 0; lane < 8; ++lane) {
+      batch.isColliding[i + lane] = (mask >> lane) & 1;
+    }
+  }
+
+  testBoxPairsSse(batch, i, end);
+}
+#endif
+
+using TestKernel = void (*)(plugins::physics::BoxPairBatch&, size_t, size_t);
+
+struct SelectedKernel {
+  TestKernel fn;
+  const char* name;
+};
+
+static const SelectedKernel& selectedKernel() {
+  static const SelectedKernel kernel = []() -> SelectedKernel {
+#ifdef QUN_NARROWPHASE_X86
+    if (util::cpu::hasAvx2()) {
+      return {testBoxPairsAvx2, "avx2"};
+    }
+
+    return {testBoxPairsSse, "sse"};
+#else
+    return {plugins::physics::testBoxPairsScalar, "scalar"};
+#endif
+  }();
+
+  return kernel;
+}
+
+void plugins::physics::testBoxPairs(BoxPairBatch& batch, size_t begin, size_t end) {
+  selectedKernel().fn(batch, begin, end);
+}
+
+const char* plugins::physics::getNarrowphaseKernelName() noexcept {
+  return selectedKernel().name;
+}
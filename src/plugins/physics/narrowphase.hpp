@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace plugins::physics {
+  // Box pairs in structure-of-arrays form, so they can be tested a vector at a time
+  struct BoxPairBatch {
+    std::vector<float> positionX1, positionY1, positionZ1;
+    std::vector<float> halfExtentsX1, halfExtentsY1, halfExtentsZ1;
+    std::vector<float> positionX2, positionY2, positionZ2;
+    std::vector<float> halfExtentsX2, halfExtentsY2, halfExtentsZ2;
+
+    // Written by testBoxPairs. Penetration is zero for pairs that don't collide.
+    std::vector<float> penetrationX, penetrationY, penetrationZ;
+    std::vector<uint8_t> isColliding;
+
+    // Sized once per batch, then every entry filled in with set
+    void resize(size_t count);
+    void set(size_t idx, const glm::vec3& pos1, const glm::vec3& halfExtents1, const glm::vec3& pos2,
+             const glm::vec3& halfExtents2);
+
+    [[nodiscard]] glm::vec3 getPenetrationDepth(size_t idx) const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+  };
+
+  // Tests pairs [begin, end) of the batch, giving exactly what Physics::checkAABBCollision would for each. Entries
+  // outside the range aren't touched, so disjoint ranges can be tested from different threads.
+  //
+  // Runs 8 pairs at a time with AVX2 or 4 with SSE, whichever the CPU supports, and scalar code elsewhere. Lanes
+  // pick their minimum axis with masks rather than branches.
+  void testBoxPairs(BoxPairBatch& batch, size_t begin, size_t end);
+
+  // Same, always on the scalar path, as a reference for the vector ones
+  void testBoxPairsScalar(BoxPairBatch& batch, size_t begin, size_t end);
+
+  // Name of the kernel testBoxPairs picked for this CPU
+  [[nodiscard]] const char* getNarrowphaseKernelName() noexcept;
+};
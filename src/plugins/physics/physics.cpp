@@ -1,18 +1,41 @@
 #include "physics.hpp"
+#include "aabb-tree.hpp"
+#include "broadphase.hpp"
+#include "contact-cache.hpp"
+#include "mesh-bvh.hpp"
+#include "narrowphase.hpp"
+#include "solver.hpp"
 
 #include "game.hpp"
 #include "components/physics.hpp"
 #include "components/transform.hpp"
 #include "resources/time.hpp"
+#include "util/thread-pool.hpp"
 
 #include <entt/entt.hpp>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
 #include <vector>
 #include <print>
 
+// Work per task when fanning the step out over the thread pool
+static constexpr size_t BODIES_PER_CHUNK = 256;
+static constexpr size_t PAIRS_PER_CHUNK = 128;
+
+// Cosine between last step's and this step's normal above which the cached impulse is reused
+static constexpr float WARM_START_MIN_ALIGNMENT = 0.95f;
+
+// Speeds under which a body counts as resting, and how long a whole island has to rest before it sleeps
+static constexpr float SLEEP_LINEAR_TOLERANCE = 0.05f;
+static constexpr float SLEEP_ANGULAR_TOLERANCE = 0.05f;
+static constexpr float TIME_TO_SLEEP = 0.5f;
+
 bool plugins::Physics::checkAABBCollision(const glm::vec3& pos1, const glm::vec3& halfExtents1, const glm::vec3& pos2,
                                           const glm::vec3& halfExtents2, glm::vec3& penetrationDepth) {
   // Calculate the distance between centers
@@ -41,157 +64,475 @@ bool plugins::Physics::checkAABBCollision(const glm::vec3& pos1, const glm::vec3
   return true;
 }
 
-void plugins::Physics::build(Game& game) {
-  game.addSystem(Schedule::Update, [](std::shared_ptr<entt::registry>& registry, resources::Time& time) {
-    float deltaTime = time.deltaTime;
-
-    // Update velocities first
-    registry->view<components::AngularVelocity, components::AngularAcceleration>().each(
-        [&registry, deltaTime](entt::entity entity, auto& angularVelocity, const auto& angularAcceleration) {
-          angularVelocity.value += angularAcceleration.value * deltaTime;
-          registry->replace<components::AngularVelocity>(entity, angularVelocity);
-        });
-
-    registry->view<components::Velocity, components::Acceleration>().each(
-        [&registry, deltaTime](entt::entity entity, auto& velocity, const auto& acceleration) {
-          velocity.value += acceleration.value * deltaTime;
-          registry->replace<components::Velocity>(entity, velocity);
-        });
-
-    // Store original positions for collision detection
-    auto colliderView = registry->view<components::Position, components::BoxCollider>();
-    std::vector<std::pair<entt::entity, glm::vec3>> originalPositions;
+// Bodies are moved in fixed steps, so have them rendered in between
+static void addInterpolation(entt::registry& registry, entt::entity entity) {
+  auto* position = registry.try_get<components::Position>(entity);
+  auto* rotation = registry.try_get<components::Rotation>(entity);
+
+  registry.emplace_or_replace<components::Interpolated>(/* clang-format off */
+    entity,
+    position ? position->value : glm::vec3(0.0f),
+    rotation ? rotation->value : glm::quat(1.0f, 0.0f, 0.0f, 0.0f)
+  ); /* clang-format on */
+}
 
-    for (auto entity : colliderView) {
-      auto& pos = colliderView.get<components::Position>(entity);
-      originalPositions.emplace_back(entity, pos.value);
+// Wakes every body that went to sleep in the same island as entity
+static void wakeIsland(entt::registry& registry, entt::entity entity) {
+  if (!registry.all_of<components::Sleeping>(entity)) {
+    return;
+  }
+
+  using plugins::physics::components::SleepState;
+  entt::entity island = registry.get_or_emplace<SleepState>(entity).island;
+
+  std::vector<entt::entity> woken;
+  auto sleepingView = registry.view<components::Sleeping, SleepState>();
+  for (entt::entity sleeper : sleepingView) {
+    if (sleeper == entity || sleepingView.get<SleepState>(sleeper).island == island) {
+      woken.push_back(sleeper);
     }
+  }
+
+  for (entt::entity sleeper : woken) {
+    registry.remove<components::Sleeping>(sleeper);
+    registry.get<SleepState>(sleeper) = {};
+    addInterpolation(registry, sleeper);
+  }
+}
+
+// Calls fn(idx, entity) for every entity in the view from the pool, returning the entities in view order.
+// fn may only touch the components of the entity it's given.
+template <typename View, typename Fn>
+static std::vector<entt::entity> parallelEach(util::ThreadPool& pool, const View& view, Fn fn) {
+  std::vector<entt::entity> entities(view.begin(), view.end());
+
+  pool.parallelFor(entities.size(), BODIES_PER_CHUNK, [&entities, &fn](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      fn(i, entities[i]);
+    }
+  });
+
+  return entities;
+}
+
+static entt::entity findIsland(std::unordered_map<entt::entity, entt::entity>& parents, entt::entity entity) {
+  while (parents[entity] != entity) {
+    parents[entity] = parents[parents[entity]];
+    entity = parents[entity];
+  }
+
+  return entity;
+}
+
+/* clang-format off */
+bool plugins::Physics::checkMeshCollision(
+  const glm::vec3& pos,
+  const glm::vec3& halfExtents,
+  const glm::vec3& meshPos,
+  const glm::vec3& meshScale,
+  const physics::MeshBvh& mesh,
+  glm::vec3& penetrationDepth
+) { /* clang-format on */
+  // The tree is in the mesh's own space, so bring the box there rather than the mesh here
+  glm::vec3 localPos = (pos - meshPos) / meshScale;
+  glm::vec3 localHalfExtents = halfExtents / glm::abs(meshScale);
+
+  glm::vec3 localPenetrationDepth;
+  if (!mesh.collideBox(physics::Aabb::fromCenter(localPos, localHalfExtents), localPenetrationDepth)) {
+    return false;
+  }
+
+  penetrationDepth = localPenetrationDepth * meshScale;
+  return true;
+}
+
+void plugins::Physics::build(Game& game) {
+  game.addResource(std::make_shared<physics::SweepAndPrune>());
+  game.addResource(std::make_shared<physics::AabbTree>());
+  game.addResource(std::make_shared<physics::ContactCache>());
+  game.addResource(std::make_shared<physics::BoxPairBatch>());
+
+  game.addSystem(Schedule::Startup, [](std::shared_ptr<entt::registry>& registry) {
+    registry->on_construct<components::Velocity>().connect<&addInterpolation>();
+
+    // Anything setting a sleeping body's velocity from outside the step wants it moving again
+    registry->on_update<components::Velocity>().connect<&wakeIsland>();
+  });
+
+  /* clang-format off */
+  game.addSystem(Schedule::FixedUpdate, "physics::step", [](
+    std::shared_ptr<entt::registry>& registry,
+    std::shared_ptr<plugins::physics::SweepAndPrune>& broadphase,
+    std::shared_ptr<plugins::physics::ContactCache>& contactCache,
+    std::shared_ptr<plugins::physics::BoxPairBatch>& boxPairBatch,
+    Read<std::shared_ptr<util::ThreadPool>> pool,
+    const resources::Time& time
+  ) {
+    float deltaTime = time.fixedDeltaTime;
+    util::ThreadPool& threadPool = **pool;
+
+    // Integration only touches each body's own components, so it runs in parallel. Velocities are written in place
+    // rather than replaced, the only listener wakes sleeping bodies and these are all awake.
+    auto angularView = registry->view<components::AngularVelocity, components::AngularAcceleration>(
+      entt::exclude<components::Sleeping>
+    );
+    parallelEach(threadPool, angularView, [&angularView, deltaTime](size_t, entt::entity entity) {
+      angularView.get<components::AngularVelocity>(entity).value +=
+        angularView.get<components::AngularAcceleration>(entity).value * deltaTime;
+    });
+
+    auto linearView = registry->view<components::Velocity, components::Acceleration>(entt::exclude<components::Sleeping>);
+    parallelEach(threadPool, linearView, [&linearView, deltaTime](size_t, entt::entity entity) {
+      linearView.get<components::Velocity>(entity).value += linearView.get<components::Acceleration>(entity).value * deltaTime;
+    });
+
+    auto colliderView = registry->view<components::Position, components::BoxCollider>();
 
     // Update rotation based on angular velocity
-    registry->view<components::Rotation, components::AngularVelocity>().each(
-        [&registry, deltaTime](entt::entity entity, auto& rotation, const auto& angularVelocity) {
-          glm::vec3 angularVel = angularVelocity.value;
-          float angle = glm::length(angularVel) * deltaTime;
-
-          if (angle > 0.0f) {
-            glm::vec3 axis = glm::normalize(angularVel);
-            glm::quat deltaRotation = glm::angleAxis(angle, axis);
-            rotation.value = deltaRotation * rotation.value;
-            registry->replace<components::Rotation>(entity, rotation);
-          }
-        });
+    auto rotationView = registry->view<components::Rotation, components::AngularVelocity>(entt::exclude<components::Sleeping>);
+    std::vector<uint8_t> isRotated(rotationView.size_hint(), 0);
+    auto rotate = [&rotationView, &isRotated, deltaTime](size_t idx, entt::entity entity) {
+      glm::vec3 angularVel = rotationView.get<components::AngularVelocity>(entity).value;
+      float angle = glm::length(angularVel) * deltaTime;
+
+      if (angle > 0.0f) {
+        auto& rotation = rotationView.get<components::Rotation>(entity);
+        rotation.value = glm::angleAxis(angle, glm::normalize(angularVel)) * rotation.value;
+        isRotated[idx] = 1;
+      }
+    };
+    auto rotated = parallelEach(threadPool, rotationView, rotate);
 
     // Update positions based on velocity
-    registry->view<components::Position, components::Velocity>().each(
-        [&registry, deltaTime](entt::entity entity, auto& position, const auto& velocity) {
-          position.value += velocity.value * deltaTime;
-          registry->replace<components::Position>(entity, position);
-        });
-
-    // Collision detection and response
-    std::vector<plugins::physics::components::CollisionEvent> collisionEvents;
-
-    // Check all pairs of colliders
-    for (auto entity1 : colliderView) {
-      auto& pos1 = colliderView.get<components::Position>(entity1);
-      auto& collider1 = colliderView.get<components::BoxCollider>(entity1);
-
-      for (auto entity2 : colliderView) {
-        // Don't check collision with self
-        if (entity1 >= entity2)
-          continue;
-
-        auto& pos2 = colliderView.get<components::Position>(entity2);
-        auto& collider2 = colliderView.get<components::BoxCollider>(entity2);
-
-        glm::vec3 penetrationDepth;
-        if (checkAABBCollision(pos1.value, collider1.halfExtents, pos2.value, collider2.halfExtents, penetrationDepth)) {
-          // Create collision event
-          plugins::physics::components::CollisionEvent event;
-          event.entity1 = entity1;
-          event.entity2 = entity2;
-          event.penetrationDepth = penetrationDepth;
-          collisionEvents.push_back(event);
-
-          // Improved collision response
-          glm::vec3 collisionNormal = glm::normalize(penetrationDepth);
-          float penetrationMagnitude = glm::length(penetrationDepth);
-
-          // Separate objects by full penetration distance plus small margin
-          glm::vec3 separation = collisionNormal * (penetrationMagnitude + 0.001f);
-
-          // Check if entities have velocity to determine mass-like behavior
-          auto* vel1 = registry->try_get<components::Velocity>(entity1);
-          auto* vel2 = registry->try_get<components::Velocity>(entity2);
-
-          if (vel1 && vel2) {
-            // Both objects can move - split separation
-            pos1.value += separation * 0.5f;
-            pos2.value -= separation * 0.5f;
-
-            // Apply velocity changes for bouncing/energy loss
-            float restitution = 0.3f; // Energy loss factor
-            glm::vec3 relativeVelocity = vel1->value - vel2->value;
-            float velocityAlongNormal = glm::dot(relativeVelocity, collisionNormal);
-
-            if (velocityAlongNormal > 0) {
-              continue; // Objects separating
-            }
-
-            float impulse = -(1 + restitution) * velocityAlongNormal;
-            glm::vec3 impulseVector = impulse * collisionNormal;
-
-            vel1->value += impulseVector * 0.5f;
-            vel2->value -= impulseVector * 0.5f;
-
-            registry->replace<components::Velocity>(entity1, *vel1);
-            registry->replace<components::Velocity>(entity2, *vel2);
-          } else if (vel1) {
-            // Only entity1 can move (entity2 is static)
-            pos1.value += separation;
-            if (glm::dot(vel1->value, collisionNormal) < 0) {
-              // Remove velocity component in collision direction
-              vel1->value -= glm::dot(vel1->value, collisionNormal) * collisionNormal * 1.3f;
-              registry->replace<components::Velocity>(entity1, *vel1);
-            }
-          } else if (vel2) {
-            // Only entity2 can move (entity1 is static)
-            pos2.value -= separation;
-            if (glm::dot(vel2->value, collisionNormal) > 0) {
-              // Remove velocity component in collision direction
-              vel2->value -= glm::dot(vel2->value, collisionNormal) * collisionNormal * 1.3f;
-              registry->replace<components::Velocity>(entity2, *vel2);
-            }
-          } else {
-            // Both are static - just separate
-            pos1.value += separation * 0.5f;
-            pos2.value -= separation * 0.5f;
-          }
-
-          // Update positions in registry
-          registry->replace<components::Position>(entity1, pos1);
-          registry->replace<components::Position>(entity2, pos2);
+    auto positionView = registry->view<components::Position, components::Velocity>(entt::exclude<components::Sleeping>);
+    auto moved = parallelEach(threadPool, positionView, [&positionView, deltaTime](size_t, entt::entity entity) {
+      positionView.get<components::Position>(entity).value += positionView.get<components::Velocity>(entity).value * deltaTime;
+    });
+
+    // Update signals aren't thread safe, so they go out afterwards in view order
+    for (size_t i = 0; i < rotated.size(); ++i) {
+      if (isRotated[i]) {
+        registry->patch<components::Rotation>(rotated[i]);
+      }
+    }
+
+    for (entt::entity entity : moved) {
+      registry->patch<components::Position>(entity);
+    }
+
+    // Only pairs whose boxes already overlap go on to the narrow phase
+    broadphase->update(*registry);
+    contactCache->beginStep();
+
+    // Meshes never move, their Position and Scale are only read
+    auto meshView = registry->view<components::Position, components::MeshCollider>();
+    auto scaleView = registry->view<components::Scale>();
+
+    // Penetration pushing entity1 out of entity2, whichever kinds of collider they have. Only reads components, so
+    // it's safe to call from the pool.
+    auto collide = [&](entt::entity entity1, entt::entity entity2, glm::vec3& penetrationDepth) {
+      auto collideMesh = [&](entt::entity body, entt::entity mesh) {
+        glm::vec3 meshScale = scaleView.contains(mesh) ? scaleView.get<components::Scale>(mesh).value : glm::vec3(1.0f);
+
+        return checkMeshCollision(
+          colliderView.get<components::Position>(body).value,
+          colliderView.get<components::BoxCollider>(body).halfExtents,
+          meshView.get<components::Position>(mesh).value,
+          meshScale,
+          *meshView.get<components::MeshCollider>(mesh).bvh,
+          penetrationDepth
+        );
+      };
+
+      if (meshView.contains(entity2)) {
+        return collideMesh(entity1, entity2);
+      }
+
+      if (meshView.contains(entity1)) {
+        bool isColliding = collideMesh(entity2, entity1);
+        penetrationDepth = -penetrationDepth;
+        return isColliding;
+      }
+
+      const auto& pos1 = colliderView.get<components::Position>(entity1);
+      const auto& collider1 = colliderView.get<components::BoxCollider>(entity1);
+      const auto& pos2 = colliderView.get<components::Position>(entity2);
+      const auto& collider2 = colliderView.get<components::BoxCollider>(entity2);
+
+      return checkAABBCollision(pos1.value, collider1.halfExtents, pos2.value, collider2.halfExtents, penetrationDepth);
+    };
+
+    // Broadphase pairs, then every awake body against every mesh. Meshes aren't in the broadphase, their own tree
+    // rejects far away boxes just as quickly.
+    std::vector<std::pair<entt::entity, entt::entity>> pairs = broadphase->findPairs();
+    size_t boxPairCount = pairs.size();
+
+    auto meshBodyView = registry->view<components::Position, components::BoxCollider, components::Velocity>(
+      entt::exclude<components::Sleeping>
+    );
+    for (entt::entity mesh : meshView) {
+      if (!meshView.get<components::MeshCollider>(mesh).bvh) {
+        continue;
+      }
+
+      for (entt::entity body : meshBodyView) {
+        pairs.push_back(std::minmax(body, mesh));
+      }
+    }
+
+    // Pairs are tested in parallel, then turned into contacts serially in pair order so the contact order (and with
+    // it the solve order) doesn't depend on the thread count
+    std::vector<glm::vec3> penetrationDepths(pairs.size());
+    std::vector<uint8_t> isColliding(pairs.size(), 0);
+
+    // Box pairs are gathered into SoA form a chunk at a time and tested a vector at a time. Kept across steps as a
+    // resource so its arrays aren't reallocated every step.
+    auto& boxPairs = *boxPairBatch;
+    boxPairs.resize(boxPairCount);
+
+    threadPool.parallelFor(pairs.size(), PAIRS_PER_CHUNK, [&](size_t begin, size_t end) {
+      size_t boxEnd = std::min(end, boxPairCount);
+      for (size_t i = begin; i < boxEnd; ++i) {
+        auto [entity1, entity2] = pairs[i];
+        boxPairs.set(
+          i,
+          colliderView.get<components::Position>(entity1).value,
+          colliderView.get<components::BoxCollider>(entity1).halfExtents,
+          colliderView.get<components::Position>(entity2).value,
+          colliderView.get<components::BoxCollider>(entity2).halfExtents
+        );
+      }
+
+      if (begin < boxEnd) {
+        plugins::physics::testBoxPairs(boxPairs, begin, boxEnd);
+
+        for (size_t i = begin; i < boxEnd; ++i) {
+          isColliding[i] = boxPairs.isColliding[i];
+          penetrationDepths[i] = boxPairs.getPenetrationDepth(i);
         }
       }
+
+      // Meshes, one pair at a time
+      for (size_t i = std::max(begin, boxPairCount); i < end; ++i) {
+        isColliding[i] = collide(pairs[i].first, pairs[i].second, penetrationDepths[i]);
+      }
+    });
+
+    std::vector<plugins::physics::Contact*> contacts;
+
+    for (size_t i = 0; i < pairs.size(); ++i) {
+      // Touching without penetrating has no normal to push along, normalizing it would only give NaN
+      float depth = glm::length(penetrationDepths[i]);
+      if (!isColliding[i] || !(depth > 0.0f)) {
+        continue;
+      }
+
+      auto [entity1, entity2] = pairs[i];
+
+      // Something awake ran into a sleeping island
+      wakeIsland(*registry, entity1);
+      wakeIsland(*registry, entity2);
+
+      auto& contact = contactCache->touch(entity1, entity2);
+      glm::vec3 normal = penetrationDepths[i] / depth;
+
+      // Last step's impulse is only a good guess if the contact is still pushing the same way
+      if (contactCache->isNew(contact) || glm::dot(contact.normal, normal) < WARM_START_MIN_ALIGNMENT) {
+        contact.normalImpulse = 0.0f;
+      }
+
+      contact.normal = normal;
+      contact.depth = depth;
+      contacts.push_back(&contact);
     }
 
-    // Process collision callbacks
-    for (const auto& event : collisionEvents) {
-      // Check if entities have collision callbacks
-      auto* callback1 = registry->try_get<plugins::physics::components::CollisionCallback>(event.entity1);
-      auto* callback2 = registry->try_get<plugins::physics::components::CollisionCallback>(event.entity2);
+    // Bodies without a velocity are treated as immovable. No components get added or removed until the solve is
+    // done, so the pointers stay put.
+    std::vector<plugins::physics::SolverContact> solverContacts;
+    solverContacts.reserve(contacts.size());
+
+    for (auto* contact : contacts) {
+      auto* vel1 = registry->try_get<components::Velocity>(contact->entity1);
+      auto* vel2 = registry->try_get<components::Velocity>(contact->entity2);
+      solverContacts.push_back({
+        .contact = contact,
+        .velocity1 = vel1 ? &vel1->value : nullptr,
+        .velocity2 = vel2 ? &vel2->value : nullptr,
+      });
+    }
+
+    // Contacts sharing a body go in different batches, so each batch can be solved in parallel
+    plugins::physics::ContactBatches batches;
+    plugins::physics::colorContacts(solverContacts, batches);
+    plugins::physics::solveVelocities(solverContacts, batches, threadPool);
+
+    // Push whatever still overlaps apart, movable bodies taking all of it from immovable ones. Only movable bodies
+    // are written, and the batches keep those apart, so this can reuse them.
+    plugins::physics::forEachBatched(batches, threadPool, [&](size_t idx) {
+      const auto& solverContact = solverContacts[idx];
+      const auto* contact = solverContact.contact;
+
+      glm::vec3 penetrationDepth;
+      if (!collide(contact->entity1, contact->entity2, penetrationDepth)) {
+        return;
+      }
+
+      float inverseMass1 = solverContact.velocity1 ? 1.0f : 0.0f;
+      float inverseMass2 = solverContact.velocity2 ? 1.0f : 0.0f;
+      float totalInverseMass = inverseMass1 + inverseMass2;
+
+      // The broadphase never pairs two bodies that aren't awake, so there's always something to move
+      if (totalInverseMass == 0.0f) {
+        return;
+      }
+
+      // Separate objects by full penetration distance plus small margin
+      glm::vec3 separation = glm::normalize(penetrationDepth) * (glm::length(penetrationDepth) + 0.001f);
+
+      // Movable bodies always have a BoxCollider, immovable ones might be a mesh
+      if (solverContact.velocity1) {
+        colliderView.get<components::Position>(contact->entity1).value += separation * (inverseMass1 / totalInverseMass);
+      }
 
-      if (callback1 && callback1->onCollisionEnter) {
-        callback1->onCollisionEnter(event);
+      if (solverContact.velocity2) {
+        colliderView.get<components::Position>(contact->entity2).value -= separation * (inverseMass2 / totalInverseMass);
       }
-      if (callback2 && callback2->onCollisionEnter) {
-        // Create event from entity2's perspective
-        plugins::physics::components::CollisionEvent reverseEvent = event;
-        reverseEvent.entity1 = event.entity2;
-        reverseEvent.entity2 = event.entity1;
-        reverseEvent.penetrationDepth = -event.penetrationDepth;
-        callback2->onCollisionEnter(reverseEvent);
+    });
+
+    for (const auto& solverContact : solverContacts) {
+      if (solverContact.velocity1) {
+        registry->patch<components::Position>(solverContact.contact->entity1);
+      }
+
+      if (solverContact.velocity2) {
+        registry->patch<components::Position>(solverContact.contact->entity2);
       }
     }
-  });
+
+    // Collision callbacks, from each entity's own perspective
+    auto notify = [&registry](
+      const plugins::physics::Contact& contact,
+      std::function<void(const plugins::physics::components::CollisionEvent&)>
+        plugins::physics::components::CollisionCallback::*handler
+    ) {
+      plugins::physics::components::CollisionEvent event;
+      event.entity1 = contact.entity1;
+      event.entity2 = contact.entity2;
+      event.penetrationDepth = contact.normal * contact.depth;
+
+      if (registry->valid(event.entity1)) {
+        auto* callback = registry->try_get<plugins::physics::components::CollisionCallback>(event.entity1);
+        if (callback && callback->*handler) {
+          (callback->*handler)(event);
+        }
+      }
+
+      if (registry->valid(event.entity2)) {
+        auto* callback = registry->try_get<plugins::physics::components::CollisionCallback>(event.entity2);
+        if (callback && callback->*handler) {
+          // Create event from entity2's perspective
+          plugins::physics::components::CollisionEvent reverseEvent = event;
+          reverseEvent.entity1 = event.entity2;
+          reverseEvent.entity2 = event.entity1;
+          reverseEvent.penetrationDepth = -event.penetrationDepth;
+          (callback->*handler)(reverseEvent);
+        }
+      }
+    };
+
+    using plugins::physics::components::CollisionCallback;
+    for (const auto* contact : contacts) {
+      bool isNew = contactCache->isNew(*contact);
+      notify(*contact, isNew ? &CollisionCallback::onCollisionEnter : &CollisionCallback::onCollisionStay);
+    }
+
+    // Bodies only sleep together with everything they're touching, static bodies excluded
+    using plugins::physics::components::SleepState;
+    std::unordered_map<entt::entity, entt::entity> islands;
+
+    auto awakeBodies = registry->view<components::Velocity>(entt::exclude<components::Sleeping>);
+    for (entt::entity entity : awakeBodies) {
+      islands[entity] = entity;
+
+      auto* angularVelocity = registry->try_get<components::AngularVelocity>(entity);
+      bool isResting =
+        glm::length(awakeBodies.get<components::Velocity>(entity).value) < SLEEP_LINEAR_TOLERANCE &&
+        (!angularVelocity || glm::length(angularVelocity->value) < SLEEP_ANGULAR_TOLERANCE);
+
+      auto& state = registry->get_or_emplace<SleepState>(entity);
+      state.restingTime = isResting ? state.restingTime + deltaTime : 0.0f;
+    }
+
+    for (const auto* contact : contacts) {
+      if (islands.contains(contact->entity1) && islands.contains(contact->entity2)) {
+        entt::entity island1 = findIsland(islands, contact->entity1);
+        entt::entity island2 = findIsland(islands, contact->entity2);
+        islands[island1] = island2;
+      }
+    }
+
+    // An island is as restless as its least rested body
+    std::unordered_map<entt::entity, float> islandRestingTimes;
+    for (auto& [entity, parent] : islands) {
+      float restingTime = registry->get<SleepState>(entity).restingTime;
+      auto [it, isInserted] = islandRestingTimes.try_emplace(findIsland(islands, entity), restingTime);
+      it->second = std::min(it->second, restingTime);
+    }
+
+    std::vector<std::pair<entt::entity, entt::entity>> sleepers;
+    for (auto& [entity, parent] : islands) {
+      entt::entity island = findIsland(islands, entity);
+      if (islandRestingTimes[island] >= TIME_TO_SLEEP) {
+        sleepers.emplace_back(entity, island);
+      }
+    }
+
+    for (auto [entity, island] : sleepers) {
+      registry->get<components::Velocity>(entity).value = glm::vec3(0.0f);
+      if (auto* angularVelocity = registry->try_get<components::AngularVelocity>(entity)) {
+        angularVelocity->value = glm::vec3(0.0f);
+      }
+
+      // Settle the rendered transform on the real position, then stop interpolating until woken
+      if (registry->all_of<components::Position>(entity)) {
+        registry->patch<components::Position>(entity);
+      }
+      registry->remove<components::Interpolated>(entity);
+
+      registry->get<SleepState>(entity).island = island;
+      registry->emplace<components::Sleeping>(entity);
+    }
+
+    auto isAwake = [&registry](entt::entity entity) {
+      return registry->all_of<components::Velocity>(entity) && !registry->all_of<components::Sleeping>(entity);
+    };
+
+    // Pairs that stopped touching, or where one side was destroyed. Contacts where neither side is awake aren't
+    // tested at all, so they're kept as they were.
+    auto ended = contactCache->endStep([&registry, &isAwake](const plugins::physics::Contact& contact) {
+      return registry->valid(contact.entity1) && registry->valid(contact.entity2) && !isAwake(contact.entity1) &&
+             !isAwake(contact.entity2);
+    });
+
+    for (auto& contact : ended) {
+      contact.depth = 0.0f;
+      notify(contact, &CollisionCallback::onCollisionExit);
+
+      // Losing a contact (eg. whatever it rested on being destroyed) can leave a sleeping island unsupported
+      for (entt::entity entity : {contact.entity1, contact.entity2}) {
+        if (registry->valid(entity)) {
+          wakeIsland(*registry, entity);
+        }
+      }
+    }
+  }); /* clang-format on */
+
+  // Registered after the step, so queries see where bodies ended up
+  /* clang-format off */
+  game.addSystem(Schedule::FixedUpdate, "physics::syncAabbTree", [](
+    Read<std::shared_ptr<entt::registry>> registry,
+    std::shared_ptr<plugins::physics::AabbTree>& tree
+  ) {
+    tree->sync(**registry);
+  }); /* clang-format on */
 }
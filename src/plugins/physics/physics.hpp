@@ -7,6 +7,10 @@ class Game;
 #include <entt/entt.hpp>
 
 namespace plugins {
+  namespace physics {
+    class MeshBvh;
+  };
+
   namespace physics::components {
     struct CollisionEvent {
       entt::entity entity1;
@@ -14,6 +18,12 @@ namespace plugins {
       glm::vec3 penetrationDepth;
     };
 
+    // How long a body has been still, and which island it went to sleep with
+    struct SleepState {
+      float restingTime = 0.0f;
+      entt::entity island = entt::null;
+    };
+
     struct CollisionCallback {
       std::function<void(const CollisionEvent&)> onCollisionEnter;
       std::function<void(const CollisionEvent&)> onCollisionStay;
@@ -27,5 +37,16 @@ namespace plugins {
   private:
     static bool checkAABBCollision(const glm::vec3& pos1, const glm::vec3& halfExtents1, const glm::vec3& pos2,
                                    const glm::vec3& halfExtents2, glm::vec3& penetrationDepth);
+
+    // Box against a mesh placed at meshPos with meshScale. penetrationDepth pushes the box out of the mesh.
+    /* clang-format off */
+    static bool checkMeshCollision(
+      const glm::vec3& pos,
+      const glm::vec3& halfExtents,
+      const glm::vec3& meshPos,
+      const glm::vec3& meshScale,
+      const physics::MeshBvh& mesh,
+      glm::vec3& penetrationDepth
+    ); /* clang-format on */
   };
 };
@@ -0,0 +1,138 @@
+#include "solver.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <unordered_map>
+
+static constexpr int VELOCITY_ITERATIONS = 4;
+
+// Fraction of the approach speed kept after an impact, and the slowest approach that still bounces
+static constexpr float RESTITUTION = 0.3f;
+static constexpr float RESTITUTION_THRESHOLD = 1.0f;
+
+// Colours are tracked as a bitmask per body
+static constexpr size_t MAX_COLORS = 64;
+
+size_t plugins::physics::ContactBatches::getBatchCount() const noexcept {
+  return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+void plugins::physics::colorContacts(const std::vector<SolverContact>& contacts, ContactBatches& batches) {
+  std::unordered_map<const glm::vec3*, uint64_t> usedColors;
+  usedColors.reserve(contacts.size() * 2);
+
+  // Colour of every contact, MAX_COLORS being the serial overflow
+  std::vector<uint32_t> colors(contacts.size());
+  std::vector<size_t> colorCounts(MAX_COLORS + 1, 0);
+
+  for (size_t i = 0; i < contacts.size(); ++i) {
+    const auto& contact = contacts[i];
+
+    uint64_t used = 0;
+    if (contact.velocity1) {
+      used |= usedColors[contact.velocity1];
+    }
+    if (contact.velocity2) {
+      used |= usedColors[contact.velocity2];
+    }
+
+    uint32_t color = static_cast<uint32_t>(std::countr_one(used));
+    if (color < MAX_COLORS) {
+      if (contact.velocity1) {
+        usedColors[contact.velocity1] |= uint64_t(1) << color;
+      }
+      if (contact.velocity2) {
+        usedColors[contact.velocity2] |= uint64_t(1) << color;
+      }
+    }
+
+    colors[i] = color;
+    colorCounts[color]++;
+  }
+
+  // Counting sort by colour, keeping contact order within a colour
+  uint32_t colorCount = 0;
+  while (colorCount < MAX_COLORS && colorCounts[colorCount] > 0) {
+    colorCount++;
+  }
+  batches.hasOverflow = colorCounts[MAX_COLORS] > 0;
+
+  batches.offsets.assign(1, 0);
+  for (uint32_t color = 0; color < colorCount; ++color) {
+    batches.offsets.push_back(batches.offsets.back() + colorCounts[color]);
+  }
+  if (batches.hasOverflow) {
+    batches.offsets.push_back(batches.offsets.back() + colorCounts[MAX_COLORS]);
+  }
+
+  // Overflow contacts go last, whatever colour index they'd have had
+  std::vector<size_t> cursor(MAX_COLORS + 1, 0);
+  for (uint32_t color = 0; color < colorCount; ++color) {
+    cursor[color] = batches.offsets[color];
+  }
+  cursor[MAX_COLORS] = batches.offsets[colorCount];
+
+  batches.order.resize(contacts.size());
+  for (size_t i = 0; i < contacts.size(); ++i) {
+    batches.order[cursor[colors[i]]++] = i;
+  }
+}
+
+static float normalVelocity(const plugins::physics::SolverContact& contact) {
+  glm::vec3 relativeVelocity = /* clang-format off */
+    (contact.velocity1 ? *contact.velocity1 : glm::vec3(0.0f)) -
+    (contact.velocity2 ? *contact.velocity2 : glm::vec3(0.0f)); /* clang-format on */
+
+  return glm::dot(relativeVelocity, contact.contact->normal);
+}
+
+// Impulse along the contact normal, pushing entity1 away from entity2
+static void applyImpulse(const plugins::physics::SolverContact& contact, float impulse) {
+  if (contact.velocity1) {
+    *contact.velocity1 += contact.contact->normal * impulse;
+  }
+
+  if (contact.velocity2) {
+    *contact.velocity2 -= contact.contact->normal * impulse;
+  }
+}
+
+/* clang-format off */
+void plugins::physics::solveVelocities(
+  std::vector<SolverContact>& contacts,
+  const ContactBatches& batches,
+  util::ThreadPool& pool
+) { /* clang-format on */
+  forEachBatched(batches, pool, [&contacts](size_t idx) {
+    auto& contact = contacts[idx];
+
+    float totalInverseMass = (contact.velocity1 ? 1.0f : 0.0f) + (contact.velocity2 ? 1.0f : 0.0f);
+    if (totalInverseMass == 0.0f) {
+      return;
+    }
+    contact.effectiveMass = 1.0f / totalInverseMass;
+
+    // Only bounce off fast impacts, resting contacts bouncing on gravity is what makes stacks jitter
+    float approachVelocity = normalVelocity(contact);
+    contact.targetVelocity = approachVelocity < -RESTITUTION_THRESHOLD ? -RESTITUTION * approachVelocity : 0.0f;
+
+    applyImpulse(contact, contact.contact->normalImpulse);
+  });
+
+  for (int iteration = 0; iteration < VELOCITY_ITERATIONS; ++iteration) {
+    forEachBatched(batches, pool, [&contacts](size_t idx) {
+      auto& contact = contacts[idx];
+      if (contact.effectiveMass == 0.0f) {
+        return;
+      }
+
+      // Contacts can only push, so clamp the running total rather than each step of it
+      float impulse = (contact.targetVelocity - normalVelocity(contact)) * contact.effectiveMass;
+      float previousImpulse = contact.contact->normalImpulse;
+      contact.contact->normalImpulse = std::max(previousImpulse + impulse, 0.0f);
+
+      applyImpulse(contact, contact.contact->normalImpulse - previousImpulse);
+    });
+  }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "contact-cache.hpp"
+#include "util/thread-pool.hpp"
+
+namespace plugins::physics {
+  // A contact as the solver sees it. Immovable sides (no Velocity) have a null velocity.
+  struct SolverContact {
+    Contact* contact;
+    glm::vec3* velocity1;
+    glm::vec3* velocity2;
+
+    float targetVelocity = 0.0f;
+    float effectiveMass = 0.0f;
+  };
+
+  // Contacts grouped so no movable body shows up twice within a batch, which lets a batch be solved in parallel.
+  // Batch i is order[offsets[i]] up to order[offsets[i + 1]].
+  struct ContactBatches {
+    std::vector<size_t> order;
+    std::vector<size_t> offsets;
+
+    // The last batch holds whatever didn't fit in any colour, and has to be solved serially
+    bool hasOverflow = false;
+
+    [[nodiscard]] size_t getBatchCount() const noexcept;
+  };
+
+  // Greedy graph colouring over the contacts' movable bodies, in contact order so the result is deterministic
+  void colorContacts(const std::vector<SolverContact>& contacts, ContactBatches& batches);
+
+  // Contacts per task, small batches aren't worth handing out
+  inline constexpr size_t CONTACTS_PER_CHUNK = 64;
+
+  // Calls fn(contactIdx) for every contact, batch by batch, in parallel within a batch
+  template <typename Fn>
+  void forEachBatched(const ContactBatches& batches, util::ThreadPool& pool, Fn&& fn) {
+    size_t batchCount = batches.getBatchCount();
+
+    for (size_t batch = 0; batch < batchCount; ++batch) {
+      size_t begin = batches.offsets[batch];
+      size_t end = batches.offsets[batch + 1];
+
+      if (batches.hasOverflow && batch == batchCount - 1) {
+        for (size_t i = begin; i < end; ++i) {
+          fn(batches.order[i]);
+        }
+        continue;
+      }
+
+      pool.parallelFor(end - begin, CONTACTS_PER_CHUNK, [&](size_t chunkBegin, size_t chunkEnd) {
+        for (size_t i = begin + chunkBegin; i < begin + chunkEnd; ++i) {
+          fn(batches.order[i]);
+        }
+      });
+    }
+  }
+
+  // Sequential impulses along each contact's normal, warm started from the impulse cached from last step.
+  // The order contacts are solved in only depends on the batches, not on the thread count.
+  void solveVelocities(std::vector<SolverContact>& contacts, const ContactBatches& batches, util::ThreadPool& pool);
+};
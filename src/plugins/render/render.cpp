@@ -10,17 +10,29 @@
 void plugins::Render::build(Game& game) {
   std::shared_ptr<Window> window;
   std::shared_ptr<Renderer> renderer;
+  std::shared_ptr<render::GpuTimers> gpuTimers;
 
   game.addResource(window);
   game.addResource(renderer);
+  game.addResource(gpuTimers);
 
   /* clang-format off */
-  game.addSystem(Schedule::Startup, [](std::shared_ptr<entt::registry>& registry, std::shared_ptr<Window>& window, std::shared_ptr<Renderer>& renderer) -> std::expected<void, std::string> {
+  game.addSystem(Schedule::Startup, [isHeadless = isHeadless, isGpuCulled = isGpuCulled, isOcclusionCulled = isOcclusionCulled, hasDepthPrePass = hasDepthPrePass](std::shared_ptr<entt::registry>& registry, std::shared_ptr<Window>& window, std::shared_ptr<Renderer>& renderer, std::shared_ptr<render::GpuTimers>& gpuTimers) -> std::expected<void, std::string> {
+#ifdef GLFW_PLATFORM_NULL
+    if (isHeadless) {
+      glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+#endif
+
     if (!glfwInit()) {
       return std::unexpected("Failed to initialize GLFW");
     }
 
-    window = std::make_shared<Window>(1280, 720, "OpenGL Window");
+    window = std::make_shared<Window>(1280, 720, "OpenGL Window", isHeadless);
+    if (!window->getGlfwWindow()) {
+      return std::unexpected(isHeadless ? "Failed to create headless GL context" : "Failed to create window");
+    }
+
     input::Keyboard::bindGlfwCallbacks(window->getGlfwWindow());
     input::Mouse::bindGlfwCallbacks(window->getGlfwWindow());
 
@@ -30,12 +42,34 @@ void plugins::Render::build(Game& game) {
 
     renderer = std::make_shared<Renderer>(window, registry);
 
+    if (isOcclusionCulled) {
+      renderer->setCullingMode(render::CullingMode::GpuOcclusion);
+    } else if (isGpuCulled) {
+      renderer->setCullingMode(render::CullingMode::Gpu);
+    }
+
+    renderer->setDepthPrePass(hasDepthPrePass);
+    gpuTimers = renderer->getGpuTimers();
+
     return {};
   }); /* clang-format on */
 
-  game.addSystem(Schedule::Render, [](std::shared_ptr<Window>& window, std::shared_ptr<Renderer>& renderer) {
+  // Held state rather than wasPressedNow, which input::reset can clear before this runs
+  /* clang-format off */
+  game.addSystem(Schedule::Update, "render::toggleDepthPrePass", [wasHeld = std::make_shared<bool>(false)](
+    std::shared_ptr<Renderer>& renderer
+  ) {
+    bool isHeld = input::Keyboard::isBeingHeld(input::Key::F2);
+    if (isHeld && !*wasHeld) {
+      renderer->setDepthPrePass(!renderer->isDepthPrePassEnabled());
+    }
+
+    *wasHeld = isHeld;
+  }); /* clang-format on */
+
+  game.addSystem(Schedule::Render, "render::drawFrame", [](std::shared_ptr<Renderer>& renderer) {
     renderer->drawFrame();
-    glfwSwapBuffers(window->getGlfwWindow());
+    renderer->present();
   });
 
   game.addSystem(Schedule::Exit, glfwTerminate);
@@ -1,11 +1,44 @@
 #pragma once
 
+#include <memory>
+#include <tuple>
 #include <entt/entt.hpp>
 
+#include "scheduler/access.hpp"
+
 class Game;
+class Window;
+class Renderer;
+
+namespace render {
+  class GpuTimers;
+};
 
 namespace plugins {
   struct Render {
+    // No visible window: GLFW's null platform with a surfaceless EGL context, drawing into an offscreen framebuffer
+    bool isHeadless = false;
+
+    // Cull 3D draws in a compute pass rather than on the CPU, see render::CullingMode
+    bool isGpuCulled = false;
+
+    // Also cull 3D draws hidden behind last frame's depth. Implies isGpuCulled.
+    bool isOcclusionCulled = false;
+
+    // Start with the 3D depth pre-pass on. F2 toggles it at runtime either way.
+    bool hasDepthPrePass = false;
+
+    // Adds the window, the renderer and its render::GpuTimers as resources, all set once the GL context is up
     void build(Game& game);
   };
 };
+
+// All need the GL context / GLFW, which only the main thread may touch
+template <> struct scheduler::IsMainThreadResource<std::shared_ptr<Window>> : std::true_type {};
+template <> struct scheduler::IsMainThreadResource<std::shared_ptr<Renderer>> : std::true_type {};
+template <> struct scheduler::IsMainThreadResource<std::shared_ptr<render::GpuTimers>> : std::true_type {};
+
+// The renderer reads the registry it was created with to gather what to draw
+template <> struct scheduler::ImpliedAccess<std::shared_ptr<Renderer>> {
+  using Params = std::tuple<scheduler::Read<std::shared_ptr<entt::registry>>>;
+};
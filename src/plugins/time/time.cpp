@@ -8,14 +8,21 @@ void plugins::Time::build(Game& game) {
   resources::Time time;
   game.addResource(time);
 
-  game.addSystem(Schedule::Startup, [](resources::Time& time) {
-    time.currentTime = glfwGetTime();
+  game.addSystem(Schedule::Startup, [syntheticDeltaTime = syntheticDeltaTime](resources::Time& time) {
+    time.currentTime = syntheticDeltaTime.has_value() ? 0.0f : glfwGetTime();
     time.lastTime = time.currentTime;
     time.deltaTime = 0.0f;
+    time.fixedAccumulator = 0.0f;
+    time.fixedAlpha = 0.0f;
   });
 
-  game.addSystem(Schedule::Update, [](resources::Time& time) {
-    time.currentTime = glfwGetTime();
+  game.addSystem(Schedule::Update, "time::update", [syntheticDeltaTime = syntheticDeltaTime](resources::Time& time) {
+    if (syntheticDeltaTime.has_value()) {
+      time.currentTime = time.lastTime + syntheticDeltaTime.value();
+    } else {
+      time.currentTime = glfwGetTime();
+    }
+
     time.deltaTime = time.currentTime - time.lastTime;
     time.lastTime = time.currentTime;
   });
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <entt/entt.hpp>
+#include <optional>
 
 class Game;
 
 namespace plugins {
   struct Time {
+    // Advance by this much every frame instead of by wall-clock time, for deterministic runs
+    std::optional<float> syntheticDeltaTime;
+
     void build(Game& game);
   };
 };
@@ -6,20 +6,15 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <print>
+#include <vector>
 
 #include "game.hpp"
+#include "resources/time.hpp"
+#include "util/trs.hpp"
 
 // TODO: when parent relationships are implemented, this is gonna be a lot more complex
 // TODO: Make these individual so you can still add position/rotation/scale at once.
 
-// Helper function to compute local transform matrix
-static glm::mat4 computeLocalTransform(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
-  glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
-  glm::mat4 rotationMatrix = glm::mat4_cast(rotation);
-  glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
-  return translationMatrix * rotationMatrix * scaleMatrix;
-}
-
 // Helper function to get parent's global transform
 static glm::mat4 getParentGlobalTransform(entt::registry& registry, entt::entity entity) {
   auto* child = registry.try_get<components::Child>(entity);
@@ -40,97 +35,167 @@ static glm::mat4 getParentGlobalTransform(entt::registry& registry, entt::entity
   return parentGlobalTransform->value;
 }
 
-// Recursively update an entity and all its children
-static void updateEntityAndChildren(entt::registry& registry, entt::entity entity) {
-  // Safety check: ensure entity is valid
-  if (!registry.valid(entity)) {
-    return;
+static void markDirty(entt::registry& registry, entt::entity entity) {
+  if (registry.valid(entity) && !registry.all_of<components::TransformDirty>(entity)) {
+    registry.emplace<components::TransformDirty>(entity);
   }
+}
 
-  // Get local transform components
-  auto position = registry.get_or_emplace<components::Position>(entity, glm::vec3(0.0f));
-  auto rotation = registry.get_or_emplace<components::Rotation>(entity, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
-  auto scale = registry.get_or_emplace<components::Scale>(entity, glm::vec3(1.0f));
+static void startup(std::shared_ptr<entt::registry> registry) {
+  // Changes only flag the entity, the actual work is batched into propagateTransforms
+  registry->on_update<components::Position>().connect<markDirty>();
+  registry->on_construct<components::Position>().connect<markDirty>();
 
-  // Compute local transform
-  glm::mat4 localTransform = computeLocalTransform(position.value, rotation.value, scale.value);
+  registry->on_update<components::Rotation>().connect<markDirty>();
+  registry->on_construct<components::Rotation>().connect<markDirty>();
 
-  // Get parent's global transform
-  glm::mat4 parentGlobalTransform = getParentGlobalTransform(registry, entity);
+  registry->on_update<components::Scale>().connect<markDirty>();
+  registry->on_construct<components::Scale>().connect<markDirty>();
 
-  // Compute and set global transform
-  glm::mat4 globalTransform = parentGlobalTransform * localTransform;
-  registry.emplace_or_replace<components::GlobalTransform>(entity, globalTransform);
+  // Parent relationships
+  registry->on_update<components::Parent>().connect<markDirty>();
+  registry->on_construct<components::Parent>().connect<markDirty>();
 
-  // Update all children
-  auto* parent = registry.try_get<components::Parent>(entity);
-  if (parent) {
-    for (entt::entity child : parent->children) {
-      // Safety check: ensure child is valid and not the same as current entity (prevent cycles)
-      if (registry.valid(child) && child != entity) {
-        updateEntityAndChildren(registry, child);
-      }
+  registry->on_construct<components::Child>().connect<markDirty>();
+  registry->on_update<components::Child>().connect<markDirty>();
+}
+
+// Remember where interpolated entities were before this fixed step moves them. Runs in PreFixedUpdate, so it doesn't
+// matter whether physics or Transform was added first.
+static void snapshotInterpolated(std::shared_ptr<entt::registry>& registry) {
+  registry->view<components::Interpolated>().each([&registry](entt::entity entity, auto& interpolated) {
+    if (auto* position = registry->try_get<components::Position>(entity)) {
+      interpolated.previousPosition = position->value;
+    }
+
+    if (auto* rotation = registry->try_get<components::Rotation>(entity)) {
+      interpolated.previousRotation = rotation->value;
     }
+  });
+}
+
+// Anything nested deeper than this is assumed to be a cycle
+static constexpr size_t MAX_HIERARCHY_DEPTH = 1024;
+
+static size_t hierarchyDepth(const entt::registry& registry, entt::entity entity) {
+  size_t depth = 0;
+
+  const auto* child = registry.try_get<components::Child>(entity);
+  while (child && registry.valid(child->parent) && child->parent != entity && depth < MAX_HIERARCHY_DEPTH) {
+    depth++;
+    child = registry.try_get<components::Child>(child->parent);
   }
+
+  return depth;
 }
 
-// Recursively update an entity and all its children (optional version for construction)
-static void updateEntityAndChildrenOptional(entt::registry& registry, entt::entity entity) {
-  // Safety check: ensure entity is valid
-  if (!registry.valid(entity)) {
-    return;
+// Local position / rotation / scale of an entity, with interpolation applied.
+// Missing components are added with their identity values, so every transformed entity ends up with a full TRS that
+// systems can view on (spawners often only give a Position).
+/* clang-format off */
+static void gatherLocalTransform(
+  entt::registry& registry,
+  entt::entity entity,
+  float alpha,
+  util::trs::Batch& batch,
+  size_t idx
+) { /* clang-format on */
+  // The entity is already flagged dirty, so the construct signals these fire don't queue anything
+  glm::vec3 positionValue = registry.get_or_emplace<components::Position>(entity, glm::vec3(0.0f)).value;
+  glm::quat rotationValue = registry.get_or_emplace<components::Rotation>(entity, glm::quat(1.0f, 0.0f, 0.0f, 0.0f)).value;
+  glm::vec3 scaleValue = registry.get_or_emplace<components::Scale>(entity, glm::vec3(1.0f)).value;
+
+  // Blend interpolated entities between the last two fixed steps, so rendering stays smooth at any frame rate
+  if (auto* interpolated = registry.try_get<components::Interpolated>(entity)) {
+    positionValue = glm::mix(interpolated->previousPosition, positionValue, alpha);
+    rotationValue = glm::slerp(interpolated->previousRotation, rotationValue, alpha);
   }
 
-  // Get local transform components (optional)
-  auto position = registry.try_get<components::Position>(entity);
-  auto rotation = registry.try_get<components::Rotation>(entity);
-  auto scale = registry.try_get<components::Scale>(entity);
+  batch.set(idx, positionValue, rotationValue, scaleValue);
+}
 
-  glm::vec3 positionValue = position ? position->value : glm::vec3(0.0f);
-  glm::quat rotationValue = rotation ? rotation->value : glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
-  glm::vec3 scaleValue = scale ? scale->value : glm::vec3(1.0f);
+// Recomputes the GlobalTransform of every dirty entity and its descendants, exactly once each.
+// Entities are processed a hierarchy level at a time, so a parent is always done before its children.
+/* clang-format off */
+static void propagateTransforms(
+  std::shared_ptr<entt::registry>& registry,
+  std::shared_ptr<plugins::transform::Propagation>& propagation,
+  const resources::Time& time
+) { /* clang-format on */
+  auto& levels = propagation->levels;
+  for (auto& level : levels) {
+    level.clear();
+  }
 
-  // Compute local transform
-  glm::mat4 localTransform = computeLocalTransform(positionValue, rotationValue, scaleValue);
+  auto enqueue = [&levels](entt::entity entity, size_t depth) {
+    if (depth >= levels.size()) {
+      levels.resize(depth + 1);
+    }
+    levels[depth].push_back(entity);
+  };
 
-  // Get parent's global transform
-  glm::mat4 parentGlobalTransform = getParentGlobalTransform(registry, entity);
+  for (entt::entity entity : registry->view<components::TransformDirty>()) {
+    enqueue(entity, hierarchyDepth(*registry, entity));
+  }
 
-  // Compute and set global transform
-  glm::mat4 globalTransform = parentGlobalTransform * localTransform;
-  registry.emplace_or_replace<components::GlobalTransform>(entity, globalTransform);
+  // Interpolated entities blend by a new alpha every frame, whether or not they moved
+  for (entt::entity entity : registry->view<components::Interpolated>(entt::exclude<components::TransformDirty>)) {
+    enqueue(entity, hierarchyDepth(*registry, entity));
+  }
 
-  // Update all children
-  auto* parent = registry.try_get<components::Parent>(entity);
-  if (parent) {
-    for (entt::entity child : parent->children) {
-      // Safety check: ensure child is valid and not the same as current entity (prevent cycles)
-      if (registry.valid(child) && child != entity) {
-        updateEntityAndChildrenOptional(registry, child);
-      }
+  for (const auto& level : levels) {
+    for (entt::entity entity : level) {
+      markDirty(*registry, entity);
     }
   }
-}
 
-static void startup(std::shared_ptr<entt::registry> registry) {
-  // Handle transform component updates
-  registry->on_update<components::Position>().connect<updateEntityAndChildren>();
-  registry->on_construct<components::Position>().connect<updateEntityAndChildrenOptional>();
+  auto& batch = propagation->batch;
+  auto& localTransforms = propagation->localTransforms;
 
-  registry->on_update<components::Rotation>().connect<updateEntityAndChildren>();
-  registry->on_construct<components::Rotation>().connect<updateEntityAndChildrenOptional>();
+  // levels grows while walking it, so index rather than iterate
+  for (size_t depth = 0; depth < levels.size(); ++depth) {
+    size_t count = levels[depth].size();
 
-  registry->on_update<components::Scale>().connect<updateEntityAndChildren>();
-  registry->on_construct<components::Scale>().connect<updateEntityAndChildrenOptional>();
+    // Local matrices for the whole level go through the SIMD kernel in one go
+    batch.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+      gatherLocalTransform(*registry, levels[depth][i], time.fixedAlpha, batch, i);
+    }
 
-  // Parent relationships
-  registry->on_update<components::Parent>().connect<updateEntityAndChildren>();
-  registry->on_construct<components::Parent>().connect<updateEntityAndChildrenOptional>();
+    localTransforms.resize(count);
+    util::trs::compose(batch, localTransforms.data());
 
-  registry->on_construct<components::Child>().connect<updateEntityAndChildrenOptional>();
-  registry->on_update<components::Child>().connect<updateEntityAndChildren>();
+    for (size_t i = 0; i < count; ++i) {
+      entt::entity entity = levels[depth][i];
+
+      glm::mat4 globalTransform = localTransforms[i];
+      if (registry->all_of<components::Child>(entity)) {
+        globalTransform = getParentGlobalTransform(*registry, entity) * globalTransform;
+      }
+      registry->emplace_or_replace<components::GlobalTransform>(entity, globalTransform);
+
+      // Children of a changed entity are stale too, unless they're already queued
+      auto* parent = registry->try_get<components::Parent>(entity);
+      if (!parent || depth + 1 >= MAX_HIERARCHY_DEPTH) {
+        continue;
+      }
+
+      for (entt::entity child : parent->children) {
+        if (registry->valid(child) && !registry->all_of<components::TransformDirty>(child)) {
+          registry->emplace<components::TransformDirty>(child);
+          enqueue(child, depth + 1);
+        }
+      }
+    }
+  }
+
+  registry->clear<components::TransformDirty>();
 }
 
 void plugins::Transform::build(Game& game) {
+  game.addResource(std::make_shared<transform::Propagation>());
+
   game.addSystem(Schedule::Startup, startup);
+  game.addSystem(Schedule::PreFixedUpdate, "transform::snapshotInterpolated", snapshotInterpolated);
+  game.addSystem(Schedule::PostUpdate, "transform::propagate", propagateTransforms);
 }
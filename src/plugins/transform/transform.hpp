@@ -1,10 +1,25 @@
 #pragma once
 
+#include <vector>
+#include <glm/glm.hpp>
 #include <entt/entt.hpp>
 
+#include "util/trs.hpp"
+
 class Game;
 
 namespace plugins {
+  namespace transform {
+    // Buffers of the propagation pass, kept as a resource so it doesn't allocate once warmed up
+    struct Propagation {
+      // Entities to recompute, by hierarchy depth
+      std::vector<std::vector<entt::entity>> levels;
+
+      util::trs::Batch batch;
+      std::vector<glm::mat4> localTransforms;
+    };
+  };
+
   struct Transform {
     void build(Game& game);
   };
@@ -0,0 +1,88 @@
+#include "depth-pyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <filesystem>
+
+#include "render/shader/shader.hpp"
+
+render::DepthPyramid::DepthPyramid(GLuint textureUnit) : textureUnit(textureUnit) {
+  auto compShader = std::make_unique<shader::Shader>(std::filesystem::path("shaders/depth-pyramid.comp"),
+                                                     shader::Type::Compute);
+
+  reduceShader = std::make_unique<shader::Program>();
+  reduceShader->addShader(std::move(compShader));
+  reduceShader->link();
+}
+
+render::DepthPyramid::~DepthPyramid() {
+  glDeleteTextures(1, &depthCopyIdx);
+  glDeleteTextures(1, &pyramidIdx);
+}
+
+void render::DepthPyramid::resize(const glm::ivec2& size) {
+  glDeleteTextures(1, &depthCopyIdx);
+  glDeleteTextures(1, &pyramidIdx);
+
+  this->size = size;
+  levelCount = std::bit_width(static_cast<unsigned>(std::max(size.x, size.y)));
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &depthCopyIdx);
+  glTextureStorage2D(depthCopyIdx, 1, GL_DEPTH_COMPONENT24, size.x, size.y);
+
+  glCreateTextures(GL_TEXTURE_2D, 1, &pyramidIdx);
+  glTextureStorage2D(pyramidIdx, levelCount, GL_R32F, size.x, size.y);
+  glTextureParameteri(pyramidIdx, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+  glTextureParameteri(pyramidIdx, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+}
+
+void render::DepthPyramid::build(const glm::mat4x4& viewProjMatrix) {
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+
+  glm::ivec2 viewportSize(viewport[2], viewport[3]);
+  if (viewportSize != size) {
+    resize(viewportSize);
+  }
+
+  glCopyTextureSubImage2D(depthCopyIdx, 0, 0, 0, viewport[0], viewport[1], size.x, size.y);
+
+  reduceShader->use();
+  glBindTextureUnit(textureUnit, depthCopyIdx);
+
+  // Level 0 is read from the depth copy, every level after from the one before it
+  for (GLint level = 0; level < levelCount; ++level) {
+    glm::ivec2 levelSize = glm::max(size >> level, glm::ivec2(1));
+
+    glUniform1i(0, level == 0);
+    if (level > 0) {
+      glBindImageTexture(0, pyramidIdx, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+    }
+    glBindImageTexture(1, pyramidIdx, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+    glDispatchCompute((levelSize.x + 7) / 8, (levelSize.y + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+  }
+
+  glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+  glBindTextureUnit(textureUnit, 0);
+
+  this->viewProjMatrix = viewProjMatrix;
+  hasBuilt = true;
+}
+
+void render::DepthPyramid::reset() noexcept {
+  hasBuilt = false;
+}
+
+bool render::DepthPyramid::isBuilt() const noexcept {
+  return hasBuilt;
+}
+
+GLuint render::DepthPyramid::getTextureIdx() const noexcept {
+  return pyramidIdx;
+}
+
+const glm::mat4x4& render::DepthPyramid::getViewProjMatrix() const noexcept {
+  return viewProjMatrix;
+}
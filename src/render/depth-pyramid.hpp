@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <memory>
+#include <glm/glm.hpp>
+
+#include "render/shader/program.hpp"
+
+namespace render {
+  // Mip chain of a frame's depth where every texel holds the farthest depth of the texels below it, so the culling
+  // pass can tell whether bounds lie entirely behind what was drawn with a handful of fetches
+  class DepthPyramid {
+  public:
+    // Takes the texture unit the depth copy is sampled from while building
+    explicit DepthPyramid(GLuint textureUnit);
+    ~DepthPyramid();
+
+    // Copies the depth of the bound read framebuffer within the current viewport, then reduces it level by level. The
+    // matrix is the one the frame was drawn with, which culling has to project bounds with to match.
+    void build(const glm::mat4x4& viewProjMatrix);
+
+    // Forgets the last build, so nothing is culled against a frame that's no longer relevant
+    void reset() noexcept;
+
+    [[nodiscard]] bool isBuilt() const noexcept;
+    [[nodiscard]] GLuint getTextureIdx() const noexcept;
+    [[nodiscard]] const glm::mat4x4& getViewProjMatrix() const noexcept;
+
+  private:
+    void resize(const glm::ivec2& size);
+
+    GLuint textureUnit;
+    std::unique_ptr<shader::Program> reduceShader;
+
+    GLuint depthCopyIdx = 0;
+    GLuint pyramidIdx = 0;
+    glm::ivec2 size = glm::ivec2(0);
+    GLsizei levelCount = 0;
+
+    glm::mat4x4 viewProjMatrix = glm::mat4x4(1.0f);
+    bool hasBuilt = false;
+  };
+};
@@ -0,0 +1,165 @@
+#include "frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "util/cpu.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define QUN_FRUSTUM_X86
+  #include <immintrin.h>
+#endif
+
+render::Frustum render::Frustum::fromMatrix(const glm::mat4x4& viewProjMatrix) noexcept {
+  // glm is column major, so rows have to be gathered by hand
+  auto row = [&](int idx) {
+    return glm::vec4(viewProjMatrix[0][idx], viewProjMatrix[1][idx], viewProjMatrix[2][idx], viewProjMatrix[3][idx]);
+  };
+
+  Frustum frustum = {/* clang-format off */
+    .planes = {
+      row(3) + row(0), // left
+      row(3) - row(0), // right
+      row(3) + row(1), // bottom
+      row(3) - row(1), // top
+      row(3) + row(2), // near
+      row(3) - row(2)  // far
+    }
+  }; /* clang-format on */
+
+  for (auto& plane : frustum.planes) {
+    plane /= glm::length(glm::vec3(plane));
+  }
+
+  return frustum;
+}
+
+void render::SphereBatch::resize(size_t count) {
+  for (auto* values : {&centerX, &centerY, &centerZ, &radius}) {
+    values->resize(count);
+  }
+
+  isVisible.resize(count);
+}
+
+void render::SphereBatch::set(size_t idx, const model::Bounds& bounds, const glm::mat4x4& transform) {
+  glm::vec3 center = glm::vec3(transform * glm::vec4(bounds.center, 1.0f));
+
+  /* clang-format off */
+  float scaleSquared = std::max({
+    glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+    glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+    glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))
+  }); /* clang-format on */
+
+  centerX[idx] = center.x;
+  centerY[idx] = center.y;
+  centerZ[idx] = center.z;
+  radius[idx] = bounds.radius * std::sqrt(scaleSquared);
+}
+
+size_t render::SphereBatch::size() const noexcept {
+  return centerX.size();
+}
+
+void render::testSpheresScalar(const Frustum& frustum, SphereBatch& batch, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    bool isVisible = true;
+    for (const auto& plane : frustum.planes) {
+      // Summed in the same order as the vector paths, so they agree on spheres touching a plane
+      float distance = (batch.centerX[i] * plane.x + batch.centerY[i] * plane.y) +
+                       (batch.centerZ[i] * plane.z + plane.w);
+      isVisible = isVisible && distance >= -batch.radius[i];
+    }
+
+    batch.isVisible[i] = isVisible;
+  }
+}
+
+#ifdef QUN_FRUSTUM_X86
+static void testSpheresSse(const render::Frustum& frustum, render::SphereBatch& batch, size_t begin, size_t end) {
+  size_t i = begin;
+  for (; i + 4 <= end; i += 4) {
+    __m128 centerX = _mm_loadu_ps(&batch.centerX[i]);
+    __m128 centerY = _mm_loadu_ps(&batch.centerY[i]);
+    __m128 centerZ = _mm_loadu_ps(&batch.centerZ[i]);
+    __m128 negRadius = _mm_xor_ps(_mm_loadu_ps(&batch.radius[i]), _mm_set1_ps(-0.0f));
+
+    __m128 isVisible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+    for (const auto& plane : frustum.planes) {
+      /* clang-format off */
+      __m128 distance = _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(plane.x)), _mm_mul_ps(centerY, _mm_set1_ps(plane.y))),
+        _mm_add_ps(_mm_mul_ps(centerZ, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w))
+      ); /* clang-format on */
+      isVisible = _mm_and_ps(isVisible, _mm_cmpge_ps(distance, negRadius));
+    }
+
+    int mask = _mm_movemask_ps(isVisible);
+    for (int lane = 0; lane < 4; ++lane) {
+      batch.isVisible[i + lane] = (mask >> lane) & 1;
+    }
+  }
+
+  render::testSpheresScalar(frustum, batch, i, end);
+}
+
+QUN_TARGET_AVX2 static void testSpheresAvx2(const render::Frustum& frustum, render::SphereBatch& batch, size_t begin,
+                                            size_t end) {
+  size_t i = begin;
+  for (; i + 8 <= end; i += 8) {
+    __m256 centerX = _mm256_loadu_ps(&batch.centerX[i]);
+    __m256 centerY = _mm256_loadu_ps(&batch.centerY[i]);
+    __m256 centerZ = _mm256_loadu_ps(&batch.centerZ[i]);
+    __m256 negRadius = _mm256_xor_ps(_mm256_loadu_ps(&batch.radius[i]), _mm256_set1_ps(-0.0f));
+
+    __m256 isVisible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+    for (const auto& plane : frustum.planes) {
+      /* clang-format off */
+      __m256 distance = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(centerX, _mm256_set1_ps(plane.x)), _mm256_mul_ps(centerY, _mm256_set1_ps(plane.y))),
+        _mm256_add_ps(_mm256_mul_ps(centerZ, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w))
+      ); /* clang-format on */
+      isVisible = _mm256_and_ps(isVisible, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+    }
+
+    int mask = _mm256_movemask_ps(isVisible);
+    for (int lane = 0; lane < 8; ++lane) {
+      batch.isVisible[i + lane] = (mask >> lane) & 1;
+    }
+  }
+
+  testSpheresSse(frustum, batch, i, end);
+}
+#endif
+
+using TestKernel = void (*)(const render::Frustum&, render::SphereBatch&, size_t, size_t);
+
+struct SelectedKernel {
+  TestKernel fn;
+  const char* name;
+};
+
+static const SelectedKernel& selectedKernel() {
+  static const SelectedKernel kernel = []() -> SelectedKernel {
+#ifdef QUN_FRUSTUM_X86
+    if (util::cpu::hasAvx2()) {
+      return {testSpheresAvx2, "avx2"};
+    }
+
+    return {testSpheresSse, "sse"};
+#else
+    return {render::testSpheresScalar, "scalar"};
+#endif
+  }();
+
+  return kernel;
+}
+
+void render::testSpheres(const Frustum& frustum, SphereBatch& batch, size_t begin, size_t end) {
+  selectedKernel().fn(frustum, batch, begin, end);
+}
+
+const char* render::getFrustumKernelName() noexcept {
+  return selectedKernel().name;
+}
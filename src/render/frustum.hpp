@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "render/model/model.hpp"
+
+namespace render {
+  // Planes facing into the view volume, normalized so dot(plane, vec4(point, 1)) is the distance of a point inside it
+  struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    // Extracts the planes of a projection * view matrix, giving a world space frustum
+    [[nodiscard]] static Frustum fromMatrix(const glm::mat4x4& viewProjMatrix) noexcept;
+  };
+
+  // World space bounding spheres in structure-of-arrays form, so they can be tested a vector at a time
+  struct SphereBatch {
+    std::vector<float> centerX, centerY, centerZ, radius;
+
+    // Written by testSpheres
+    std::vector<uint8_t> isVisible;
+
+    // Sized once per batch, then every entry filled in with set
+    void resize(size_t count);
+
+    // Moves model space bounds to world space. The radius is scaled by the largest axis scale, so it stays
+    // conservative under non-uniform scaling.
+    void set(size_t idx, const model::Bounds& bounds, const glm::mat4x4& transform);
+
+    [[nodiscard]] size_t size() const noexcept;
+  };
+
+  // Tests spheres [begin, end) of the batch against every plane. Spheres that cross a plane count as visible.
+  //
+  // Runs 8 spheres at a time with AVX2 or 4 with SSE, whichever the CPU supports, and scalar code elsewhere.
+  void testSpheres(const Frustum& frustum, SphereBatch& batch, size_t begin, size_t end);
+
+  // Same, always on the scalar path, as a reference for the vector ones
+  void testSpheresScalar(const Frustum& frustum, SphereBatch& batch, size_t begin, size_t end);
+
+  // Name of the kernel testSpheres picked for this CPU
+  [[nodiscard]] const char* getFrustumKernelName() noexcept;
+};
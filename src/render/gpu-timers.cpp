@@ -0,0 +1,82 @@
+#include "gpu-timers.hpp"
+
+#include <vector>
+
+render::GpuTimers::~GpuTimers() {
+  for (auto& scope : scopes) {
+    glDeleteQueries(static_cast<GLsizei>(scope.queryIdxs.size()), scope.queryIdxs.data());
+  }
+}
+
+size_t render::GpuTimers::addScope(std::string name) {
+  auto& scope = scopes.emplace_back();
+  scope.profile = {.name = std::move(name), .category = "gpu", .stats = {}};
+  glCreateQueries(GL_TIME_ELAPSED, static_cast<GLsizei>(scope.queryIdxs.size()), scope.queryIdxs.data());
+
+  return scopes.size() - 1;
+}
+
+void render::GpuTimers::begin(size_t scopeIdx) {
+  auto& scope = scopes[scopeIdx];
+  size_t slot = frame % QUERIES_PER_SCOPE;
+
+  // Still waiting on the result from QUERIES_PER_SCOPE frames ago
+  scope.isTiming = !scope.isPending[slot];
+  if (scope.isTiming) {
+    glBeginQuery(GL_TIME_ELAPSED, scope.queryIdxs[slot]);
+  }
+}
+
+void render::GpuTimers::end(size_t scopeIdx) {
+  auto& scope = scopes[scopeIdx];
+  if (!scope.isTiming) {
+    return;
+  }
+
+  glEndQuery(GL_TIME_ELAPSED);
+  scope.isPending[frame % QUERIES_PER_SCOPE] = true;
+  scope.isTiming = false;
+}
+
+void render::GpuTimers::beginFrame() {
+  for (auto& scope : scopes) {
+    // Oldest first, so samples land in the order they were timed
+    for (size_t i = 1; i <= QUERIES_PER_SCOPE; ++i) {
+      size_t slot = (frame + i) % QUERIES_PER_SCOPE;
+      if (!scope.isPending[slot]) {
+        continue;
+      }
+
+      GLint isAvailable = GL_FALSE;
+      glGetQueryObjectiv(scope.queryIdxs[slot], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+      if (!isAvailable) {
+        continue;
+      }
+
+      GLuint64 nanoseconds = 0;
+      glGetQueryObjectui64v(scope.queryIdxs[slot], GL_QUERY_RESULT, &nanoseconds);
+      scope.profile.stats.add(static_cast<float>(static_cast<double>(nanoseconds) / 1e6));
+      scope.isPending[slot] = false;
+    }
+  }
+
+  ++frame;
+}
+
+const scheduler::ProfileScope& render::GpuTimers::getScope(size_t scopeIdx) const {
+  return scopes[scopeIdx].profile;
+}
+
+size_t render::GpuTimers::getScopeCount() const noexcept {
+  return scopes.size();
+}
+
+std::string render::GpuTimers::report() const {
+  std::vector<const scheduler::ProfileScope*> profiles;
+  profiles.reserve(scopes.size());
+  for (const auto& scope : scopes) {
+    profiles.push_back(&scope.profile);
+  }
+
+  return scheduler::formatReport(profiles);
+}
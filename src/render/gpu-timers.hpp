@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+
+#include "scheduler/profiler.hpp"
+
+namespace render {
+  // GPU time spent between pairs of begin / end calls, kept per scope as rolling stats in milliseconds, like the CPU
+  // side's scheduler::Profiler.
+  //
+  // Every scope cycles through a few GL_TIME_ELAPSED queries and only reads one back once its result is available,
+  // so timing never waits on the GPU. Results show up a frame or two late. If all of a scope's queries are still in
+  // flight the scope goes untimed that frame rather than stalling.
+  //
+  // Timed ranges can't nest or overlap, as GL only runs one GL_TIME_ELAPSED query at a time.
+  class GpuTimers {
+  public:
+    static constexpr size_t QUERIES_PER_SCOPE = 3;
+
+    GpuTimers() = default;
+    ~GpuTimers();
+
+    GpuTimers(const GpuTimers&) = delete;
+    GpuTimers& operator=(const GpuTimers&) = delete;
+
+    size_t addScope(std::string name);
+
+    void begin(size_t scopeIdx);
+    void end(size_t scopeIdx);
+
+    // Collects whichever results have come in, then moves every scope on to its next query
+    void beginFrame();
+
+    [[nodiscard]] const scheduler::ProfileScope& getScope(size_t scopeIdx) const;
+    [[nodiscard]] size_t getScopeCount() const noexcept;
+
+    // Table of min / avg / p99 for every scope that has samples
+    [[nodiscard]] std::string report() const;
+
+  private:
+    struct Scope {
+      scheduler::ProfileScope profile;
+      std::array<GLuint, QUERIES_PER_SCOPE> queryIdxs;
+
+      // Issued and not yet read back
+      std::array<bool, QUERIES_PER_SCOPE> isPending = {};
+
+      // Whether this frame's begin issued a query, so end knows to close it
+      bool isTiming = false;
+    };
+
+    // A deque so references handed out by getScope stay valid as scopes are added
+    std::deque<Scope> scopes;
+    uint64_t frame = 0;
+  };
+};
@@ -0,0 +1,152 @@
+#include "light-clusters.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+// Tiles a range of normalized device coordinates covers, first to last, or an empty range when it's off screen
+static std::pair<int, int> getTileRange(float minNdc, float maxNdc, GLuint tileCount) noexcept {
+  if (maxNdc < -1.0f || minNdc > 1.0f) {
+    return {1, 0};
+  }
+
+  auto toTile = [tileCount](float ndc) {
+    float tile = std::floor((std::clamp(ndc, -1.0f, 1.0f) * 0.5f + 0.5f) * static_cast<float>(tileCount));
+    return std::clamp(static_cast<int>(tile), 0, static_cast<int>(tileCount) - 1);
+  };
+
+  return {toTile(minNdc), toTile(maxNdc)};
+}
+
+// Range of coord / depth over a box spanning [minCoord, maxCoord] and [minDepth, maxDepth], scaled as the projection
+// does. Extremes of that are always at corners of the box.
+static std::pair<float, float> projectRange(float minCoord, float maxCoord, float minDepth, float maxDepth,
+                                            float scale) noexcept {
+  float min = minCoord / (minCoord >= 0.0f ? maxDepth : minDepth);
+  float max = maxCoord / (maxCoord >= 0.0f ? minDepth : maxDepth);
+  return {min * scale, max * scale};
+}
+
+// View space range of a tile along one axis, over [minDepth, maxDepth]
+static std::pair<float, float> getTileViewRange(int tile, GLuint tileCount, float minDepth, float maxDepth,
+                                                float scale) noexcept {
+  float minNdc = static_cast<float>(tile) / static_cast<float>(tileCount) * 2.0f - 1.0f;
+  float maxNdc = static_cast<float>(tile + 1) / static_cast<float>(tileCount) * 2.0f - 1.0f;
+
+  // Edges of the tile spread out with depth
+  float min = std::min(minNdc * minDepth, minNdc * maxDepth) / scale;
+  float max = std::max(maxNdc * minDepth, maxNdc * maxDepth) / scale;
+  return {min, max};
+}
+
+GLuint render::LightClusters::getSlice(float depth) const noexcept {
+  int slice = static_cast<int>(std::floor(std::log(depth) * sliceScale + sliceBias));
+  return static_cast<GLuint>(std::clamp(slice, 0, static_cast<int>(SLICES) - 1));
+}
+
+void render::LightClusters::build(std::span<const Light> lights, const glm::mat4x4& viewMatrix,
+                                  const glm::mat4x4& projMatrix, float nearPlane) {
+  sliceScale = static_cast<float>(SLICES) / std::log(SLICE_FAR_DEPTH / SLICE_NEAR_DEPTH);
+  sliceBias = -std::log(SLICE_NEAR_DEPTH) * sliceScale;
+
+  lightAssignments.clear();
+  clusterLights.assign(CLUSTER_COUNT, {});
+
+  // The first and last slices stretch to the near plane and to infinity
+  auto getSliceNearDepth = [this, nearPlane](GLuint slice) {
+    return slice == 0 ? nearPlane : std::exp((static_cast<float>(slice) - sliceBias) / sliceScale);
+  };
+  auto getSliceFarDepth = [this, &getSliceNearDepth](GLuint slice) {
+    return slice == SLICES - 1 ? std::numeric_limits<float>::max() : getSliceNearDepth(slice + 1);
+  };
+
+  for (size_t i = 0; i < lights.size(); ++i) {
+    const auto& light = lights[i];
+    if (light.radius <= 0.0f) {
+      continue;
+    }
+
+    // View space looks down -z, so depths are negated
+    glm::vec3 center = glm::vec3(viewMatrix * glm::vec4(light.position, 1.0f));
+    float minDepth = -center.z - light.radius;
+    float maxDepth = -center.z + light.radius;
+    if (maxDepth <= nearPlane) {
+      continue;
+    }
+
+    GLuint firstSlice = getSlice(std::max(minDepth, nearPlane));
+    GLuint lastSlice = getSlice(maxDepth);
+
+    // The box around the light is projected slice by slice, which keeps tiles tight for lights spanning many slices
+    for (GLuint slice = firstSlice; slice <= lastSlice; ++slice) {
+      float sliceMinDepth = std::max(minDepth, getSliceNearDepth(slice));
+      float sliceMaxDepth = std::min(maxDepth, getSliceFarDepth(slice));
+
+      auto [minNdcX, maxNdcX] = /* clang-format off */
+        projectRange(center.x - light.radius, center.x + light.radius, sliceMinDepth, sliceMaxDepth, projMatrix[0][0]);
+      auto [minNdcY, maxNdcY] =
+        projectRange(center.y - light.radius, center.y + light.radius, sliceMinDepth, sliceMaxDepth, projMatrix[1][1]);
+      /* clang-format on */
+
+      auto [minX, maxX] = getTileRange(minNdcX, maxNdcX, TILES_X);
+      auto [minY, maxY] = getTileRange(minNdcY, maxNdcY, TILES_Y);
+      if (minX > maxX || minY > maxY) {
+        continue;
+      }
+
+      float offsetZ = std::max({sliceMinDepth + center.z, -center.z - sliceMaxDepth, 0.0f});
+
+      // View space box of each cluster within the light's depth range, tested against the light's sphere
+      for (int y = minY; y <= maxY; ++y) {
+        auto [minViewY, maxViewY] = getTileViewRange(y, TILES_Y, sliceMinDepth, sliceMaxDepth, projMatrix[1][1]);
+        float offsetY = std::max({minViewY - center.y, center.y - maxViewY, 0.0f});
+
+        for (int x = minX; x <= maxX; ++x) {
+          auto [minViewX, maxViewX] = getTileViewRange(x, TILES_X, sliceMinDepth, sliceMaxDepth, projMatrix[0][0]);
+          float offsetX = std::max({minViewX - center.x, center.x - maxViewX, 0.0f});
+
+          if (offsetX * offsetX + offsetY * offsetY + offsetZ * offsetZ > light.radius * light.radius) {
+            continue;
+          }
+
+          GLuint clusterIdx = x + TILES_X * (y + TILES_Y * slice);
+          lightAssignments.push_back({.clusterIdx = clusterIdx, .lightIdx = static_cast<GLuint>(i)});
+          clusterLights[clusterIdx].lightCount++;
+        }
+      }
+    }
+  }
+
+  // Counts become offsets, then are counted back up while the lists are filled in, in light order
+  GLuint lightOffset = 0;
+  for (auto& cluster : clusterLights) {
+    cluster.firstLight = lightOffset;
+    lightOffset += cluster.lightCount;
+    cluster.lightCount = 0;
+  }
+
+  lightIndices.resize(lightOffset);
+  for (const auto& assignment : lightAssignments) {
+    auto& cluster = clusterLights[assignment.clusterIdx];
+    lightIndices[cluster.firstLight + cluster.lightCount++] = assignment.lightIdx;
+  }
+}
+
+render::ClusterGrid render::LightClusters::getGrid(const glm::vec4& viewport) const noexcept {
+  /* clang-format off */
+  return {
+    .viewport = viewport,
+    .size = glm::uvec3(TILES_X, TILES_Y, SLICES),
+    .sliceScale = sliceScale,
+    .sliceBias = sliceBias
+  }; /* clang-format on */
+}
+
+std::span<const render::ClusterLights> render::LightClusters::getClusterLights() const noexcept {
+  return clusterLights;
+}
+
+std::span<const GLuint> render::LightClusters::getLightIndices() const noexcept {
+  return lightIndices;
+}
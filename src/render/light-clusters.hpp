@@ -0,0 +1,80 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace render {
+  // Laid out as std430
+  struct Light {
+    glm::vec3 position;
+    float radius;
+    glm::vec3 color;
+    float _padding;
+  };
+
+  // What the 3D shaders need to find the cluster of a fragment. Laid out as std140.
+  struct ClusterGrid {
+    // x, y, width, height in pixels
+    glm::vec4 viewport;
+    glm::uvec3 size;
+
+    // Slice of a view space depth d is log(d) * sliceScale + sliceBias
+    float sliceScale;
+    float sliceBias;
+  };
+
+  // Where a cluster's lights are in the light index list
+  struct ClusterLights {
+    GLuint firstLight;
+    GLuint lightCount;
+  };
+
+  // Splits the view frustum into tiles across the screen and slices along depth, spaced exponentially so they grow
+  // with distance like tiles do, and lists the lights reaching into each. Fragments then only shade with the lights
+  // of their cluster.
+  //
+  // Lights are assigned by range, each one only visiting the clusters its bounds overlap, then tested against each of
+  // those clusters' box, so building costs about as much as the lists it writes.
+  class LightClusters {
+  public:
+    static constexpr GLuint TILES_X = 32;
+    static constexpr GLuint TILES_Y = 18;
+    static constexpr GLuint SLICES = 48;
+    static constexpr size_t CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+
+    // View depths the slices are spread over. Anything nearer falls in the first slice and anything farther in the
+    // last, which keeps slices thin where lights are actually seen instead of spending most of them near the camera.
+    static constexpr float SLICE_NEAR_DEPTH = 1.0f;
+    static constexpr float SLICE_FAR_DEPTH = 1000.0f;
+
+    // Lights are world space. The projection has to be a symmetric perspective one, as built by glm::perspective, with
+    // its near plane passed along.
+    void build(std::span<const Light> lights, const glm::mat4x4& viewMatrix, const glm::mat4x4& projMatrix,
+               float nearPlane);
+
+    [[nodiscard]] ClusterGrid getGrid(const glm::vec4& viewport) const noexcept;
+
+    // Indexed by x + TILES_X * (y + TILES_Y * slice)
+    [[nodiscard]] std::span<const ClusterLights> getClusterLights() const noexcept;
+    [[nodiscard]] std::span<const GLuint> getLightIndices() const noexcept;
+
+  private:
+    struct LightAssignment {
+      GLuint clusterIdx;
+      GLuint lightIdx;
+    };
+
+    [[nodiscard]] GLuint getSlice(float depth) const noexcept;
+
+    float sliceScale = 0.0f;
+    float sliceBias = 0.0f;
+
+    std::vector<LightAssignment> lightAssignments;
+    std::vector<ClusterLights> clusterLights;
+    std::vector<GLuint> lightIndices;
+  };
+};
@@ -1,20 +1,20 @@
 #include "material3d.hpp"
 
 #include "render/texture.hpp"
+#include <algorithm>
 #include <glm/matrix.hpp>
 #include <print>
 
-material::Manager3D::Manager3D(uniform::Block<material::Material3D> uniformMaterial, std::shared_ptr<texture::Manager> texMan)
-    : uniformMaterial(uniformMaterial), textureManager(texMan) {
+material::Manager3D::Manager3D(GLuint binding, std::shared_ptr<texture::Manager> texMan)
+    : binding(binding), textureManager(texMan) {
 }
 
 material::Manager3D::~Manager3D() {
+  glDeleteBuffers(1, &bufferIdx);
 }
 
-// todo: might be able to combine these in the future.
-void material::Manager3D::setMaterial(const asset::Material& material) noexcept {
-  /* clang-format off */
-  material::Material3D newMaterial = {
+material::Material3D material::Manager3D::convert(const asset::Material& material) noexcept {
+  return material::Material3D{/* clang-format off */
     .ambient = material.ambient,
     .shininess = material.shininess,
     .diffuse = material.diffuse,
@@ -26,15 +26,84 @@ void material::Manager3D::setMaterial(const asset::Material& material) noexcept
     .normalTexture = material.normalTexture.value_or(texture::Texture{}),
     .emissiveTexture = material.emissiveTexture.value_or(texture::Texture{}),
   };/* clang-format on */
+}
 
-  setMaterial(newMaterial);
+void material::Manager3D::markDirty(size_t index) noexcept {
+  if (dirtyBegin == dirtyEnd) {
+    dirtyBegin = index;
+    dirtyEnd = index + 1;
+  } else {
+    dirtyBegin = std::min(dirtyBegin, index);
+    dirtyEnd = std::max(dirtyEnd, index + 1);
+  }
 }
 
-void material::Manager3D::setMaterial(const material::Material3D& material) noexcept {
-  uniformMaterial.set(material);
-  currentMaterial = material;
+GLuint material::Manager3D::add(const asset::Material& material) {
+  auto index = static_cast<GLuint>(materials.size());
+  materials.push_back(convert(material));
+  markDirty(index);
+
+  return index;
+}
+
+void material::Manager3D::set(GLuint index, const asset::Material& material) {
+  auto converted = convert(material);
+  if (materials[index] == converted) {
+    return;
+  }
+
+  materials[index] = converted;
+  markDirty(index);
+}
+
+GLuint material::Manager3D::getIndex(const asset::Material& material) {
+  auto it = trackedMaterials.find(&material);
+  if (it == trackedMaterials.end()) {
+    GLuint index = add(material);
+    trackedMaterials.emplace(&material, TrackedMaterial{.index = index, .checkedFrame = frame});
+    return index;
+  }
+
+  // Also catches a new material reusing the address of a freed one
+  if (it->second.checkedFrame != frame) {
+    it->second.checkedFrame = frame;
+    set(it->second.index, material);
+  }
+
+  return it->second.index;
 }
 
-material::Material3D material::Manager3D::getMaterial() const noexcept {
-  return currentMaterial;
+bool material::Manager3D::isTranslucent(GLuint index) const noexcept {
+  return materials[index].dissolve < 1.0f;
+}
+
+void material::Manager3D::upload() {
+  ++frame;
+
+  if (materials.size() > bufferCapacity) {
+    // Storage is immutable, so growing means a new buffer with everything re-sent
+    glDeleteBuffers(1, &bufferIdx);
+
+    bufferCapacity = std::max<size_t>(materials.size() * 2, 64);
+    glCreateBuffers(1, &bufferIdx);
+    glNamedBufferStorage(bufferIdx, sizeof(material::Material3D) * bufferCapacity, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    dirtyBegin = 0;
+    dirtyEnd = materials.size();
+  }
+
+  if (dirtyBegin < dirtyEnd) {
+    /* clang-format off */
+    glNamedBufferSubData(
+      bufferIdx,
+      sizeof(material::Material3D) * dirtyBegin,
+      sizeof(material::Material3D) * (dirtyEnd - dirtyBegin),
+      materials.data() + dirtyBegin
+    ); /* clang-format on */
+
+    dirtyBegin = 0;
+    dirtyEnd = 0;
+  }
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, bufferIdx);
 }
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <rapidobj/rapidobj.hpp>
+#include <unordered_map>
+#include <vector>
 
-#include "render/uniform/block.hpp"
 #include "render/texture.hpp"
 
 #include "asset/asset.hpp"
@@ -22,23 +23,57 @@ namespace material {
     texture::Texture diffuseTexture;
     texture::Texture normalTexture;
     texture::Texture emissiveTexture;
+
+    bool operator==(const Material3D&) const = default;
   };
 
   static_assert(sizeof(Material3D) % 16 == 0, "Ensure Material3D is std140 compliant");
 
+  // Table of every material the 3D shaders can index into. Entries are converted once and only re-sent to the GPU
+  // when they change.
   class Manager3D {
   public:
-    Manager3D(uniform::Block<material::Material3D> uniformMaterial, std::shared_ptr<texture::Manager> texMan);
+    Manager3D(GLuint binding, std::shared_ptr<texture::Manager> texMan);
     ~Manager3D();
 
-    void setMaterial(const asset::Material& material) noexcept;
-    void setMaterial(const material::Material3D& material) noexcept;
-    [[nodiscard]] material::Material3D getMaterial() const noexcept;
+    // Adds a material for good, returning the index the shaders read it at
+    [[nodiscard]] GLuint add(const asset::Material& material);
+
+    // Overwrites a material added earlier
+    void set(GLuint index, const asset::Material& material);
+
+    // Index of a material owned outside the renderer, e.g. by a components::Material3D. It's added on first use, then
+    // compared against its entry once per frame so edits to it are picked up.
+    [[nodiscard]] GLuint getIndex(const asset::Material& material);
+
+    // Whether a material lets what's behind it show through, so has to be drawn after opaque ones, back to front
+    [[nodiscard]] bool isTranslucent(GLuint index) const noexcept;
+
+    // Sends the entries changed since the last upload and binds the table to the shader storage binding it was created
+    // with. Called once per frame, before drawing.
+    void upload();
 
   private:
+    struct TrackedMaterial {
+      GLuint index;
+      uint64_t checkedFrame;
+    };
+
+    static material::Material3D convert(const asset::Material& material) noexcept;
+    void markDirty(size_t index) noexcept;
+
     std::shared_ptr<texture::Manager> textureManager;
 
-    uniform::Block<material::Material3D> uniformMaterial;
-    material::Material3D currentMaterial;
+    GLuint binding;
+    GLuint bufferIdx = 0;
+    size_t bufferCapacity = 0;
+
+    std::vector<material::Material3D> materials;
+    std::unordered_map<const asset::Material*, TrackedMaterial> trackedMaterials;
+    uint64_t frame = 0;
+
+    // Range of materials that changed since the last upload
+    size_t dirtyBegin = 0;
+    size_t dirtyEnd = 0;
   };
 };
@@ -12,7 +12,6 @@ model::Asset::Asset(/* clang-format off */
   std::shared_ptr<texture::Manager> texMan,
   std::shared_ptr<material::Manager3D> matMan
 ):
-  inner(asset),
   textureManager(texMan),
   materialManager(matMan)
 {/* clang-format on */
@@ -44,12 +43,33 @@ model::Asset::Asset(/* clang-format off */
     glVertexArrayElementBuffer(glAttributesIdx, glIndexBufferIdx); // Bind index buffer to VAO
   }
 
+  // Materials are added to the table once, so drawing a group only costs its index
+  std::vector<GLuint> materialIndices;
+  for (const auto& material : asset.materials) {
+    materialIndices.push_back(materialManager->add(material));
+  }
+
+  GLuint defaultMaterialIdx = materialManager->getIndex(constants::DEFAULT_MATERIAL_3D);
+
   // Recursive function to traverse nodes and collect material groups
   std::function<void(size_t)> traverseNode = [&](size_t nodeIndex) {
     const auto& node = asset.nodes[nodeIndex];
     for (const auto& group : node.groups) {
+      GLuint materialIdx = defaultMaterialIdx;
+      if (group.materialId.has_value()) {
+        materialIdx = materialIndices[group.materialId.value()];
+      }
+
+      submeshes.push_back({/* clang-format off */
+        .firstIndex = static_cast<GLuint>(allIndices.size()),
+        .indexCount = static_cast<GLuint>(group.indices.size()),
+        .materialIdx = materialIdx
+      }); /* clang-format on */
+
       allIndices.insert(allIndices.end(), group.indices.begin(), group.indices.end());
-      materialGroups.push_back(group);
+
+      auto groupIndices = std::span(allIndices).subspan(submeshes.back().firstIndex, group.indices.size());
+      submeshes.back().bounds = model::Bounds::fromIndexedVertices(asset.vertices, groupIndices);
     }
 
     // Recursively traverse child nodes
@@ -63,6 +83,8 @@ model::Asset::Asset(/* clang-format off */
     traverseNode(rootNodeIndex);
   }
 
+  bounds = model::Bounds::fromIndexedVertices(asset.vertices, allIndices);
+
   glNamedBufferData(glBufferIdx, sizeof(Vertex3D) * asset.vertices.size(), asset.vertices.data(), GL_STATIC_DRAW);
   glNamedBufferData(glIndexBufferIdx, sizeof(GLuint) * allIndices.size(), allIndices.data(), GL_STATIC_DRAW);
 }
@@ -73,19 +95,14 @@ model::Asset::~Asset() {
   glDeleteBuffers(1, &glIndexBufferIdx);
 }
 
-void model::Asset::draw() const {
-  glBindVertexArray(glAttributesIdx);
+GLuint model::Asset::getVertexArray() const {
+  return glAttributesIdx;
+}
 
-  size_t currentOffset = 0;
-  for (const auto& group : materialGroups) {
-    if (group.materialId.has_value()) {
-      const auto& material = inner.materials[group.materialId.value()];
-      materialManager->setMaterial(material);
-    } else {
-      materialManager->setMaterial(constants::DEFAULT_MATERIAL_3D);
-    }
+std::span<const model::Submesh> model::Asset::getSubmeshes() const {
+  return submeshes;
+}
 
-    glDrawElements(GL_TRIANGLES, group.indices.size(), GL_UNSIGNED_INT, (void*)currentOffset);
-    currentOffset += group.indices.size() * sizeof(GLuint);
-  }
+const model::Bounds& model::Asset::getBounds() const {
+  return bounds;
 }
@@ -11,15 +11,18 @@ namespace model {
   public:
     Asset(const asset::Asset3D& asset, std::shared_ptr<texture::Manager> texMan, std::shared_ptr<material::Manager3D> matMan);
     ~Asset();
-    void draw() const;
+    [[nodiscard]] GLuint getVertexArray() const;
+    [[nodiscard]] std::span<const model::Submesh> getSubmeshes() const;
+    [[nodiscard]] const model::Bounds& getBounds() const;
 
   private:
     std::shared_ptr<texture::Manager> textureManager;
     std::shared_ptr<material::Manager3D> materialManager;
 
-    std::vector<asset::MaterialGroup> materialGroups;
+    // One per material group
+    std::vector<model::Submesh> submeshes;
+    model::Bounds bounds;
 
-    asset::Asset3D inner;
     std::vector<GLuint> allIndices;
     GLuint glAttributesIdx;
     GLuint glBufferIdx;
@@ -90,6 +90,12 @@ model::Cube::Cube(glm::vec3 scale) : scale(scale) {
 
   glNamedBufferData(glBufferIdx, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
   glNamedBufferData(glIndexBufferIdx, sizeof(indices), indices.data(), GL_STATIC_DRAW);
+
+  submesh = {/* clang-format off */
+    .firstIndex = 0,
+    .indexCount = static_cast<GLuint>(indices.size()),
+    .bounds = model::Bounds::fromIndexedVertices(vertices, indices)
+  }; /* clang-format on */
 }
 
 model::Cube::~Cube() {
@@ -98,7 +104,14 @@ model::Cube::~Cube() {
   glDeleteBuffers(1, &glIndexBufferIdx);
 }
 
-void model::Cube::draw() const {
-  glBindVertexArray(glAttributesIdx);
-  glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+GLuint model::Cube::getVertexArray() const {
+  return glAttributesIdx;
+}
+
+std::span<const model::Submesh> model::Cube::getSubmeshes() const {
+  return {&submesh, 1};
+}
+
+const model::Bounds& model::Cube::getBounds() const {
+  return submesh.bounds;
 }
@@ -13,7 +13,9 @@ namespace model {
   public:
     Cube(glm::vec3 scale);
     ~Cube();
-    void draw() const;
+    [[nodiscard]] GLuint getVertexArray() const;
+    [[nodiscard]] std::span<const model::Submesh> getSubmeshes() const;
+    [[nodiscard]] const model::Bounds& getBounds() const;
 
   private:
     glm::vec3 scale;
@@ -23,5 +25,7 @@ namespace model {
     GLuint glAttributesIdx;
     GLuint glBufferIdx;
     GLuint glIndexBufferIdx;
+
+    model::Submesh submesh;
   };
 }
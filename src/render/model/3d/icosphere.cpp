@@ -56,6 +56,12 @@ model::Icosphere::Icosphere(float radius, int subdivisions) : radius(radius), su
 
   glNamedBufferData(glBufferIdx, vertices.size() * sizeof(Vertex3D), vertices.data(), GL_STATIC_DRAW);
   glNamedBufferData(glIndexBufferIdx, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+  submesh = {/* clang-format off */
+    .firstIndex = 0,
+    .indexCount = static_cast<GLuint>(indices.size()),
+    .bounds = model::Bounds::fromIndexedVertices(vertices, indices)
+  }; /* clang-format on */
 }
 
 model::Icosphere::~Icosphere() {
@@ -64,9 +70,16 @@ model::Icosphere::~Icosphere() {
   glDeleteBuffers(1, &glIndexBufferIdx);
 }
 
-void model::Icosphere::draw() const {
-  glBindVertexArray(glAttributesIdx);
-  glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+GLuint model::Icosphere::getVertexArray() const {
+  return glAttributesIdx;
+}
+
+std::span<const model::Submesh> model::Icosphere::getSubmeshes() const {
+  return {&submesh, 1};
+}
+
+const model::Bounds& model::Icosphere::getBounds() const {
+  return submesh.bounds;
 }
 
 void model::Icosphere::generateIcosphere(float radius, int subdivisions) {
@@ -13,7 +13,9 @@ namespace model {
   public:
     Icosphere(float radius = 1.0f, int subdivisions = 2);
     ~Icosphere();
-    void draw() const;
+    [[nodiscard]] GLuint getVertexArray() const;
+    [[nodiscard]] std::span<const model::Submesh> getSubmeshes() const;
+    [[nodiscard]] const model::Bounds& getBounds() const;
 
   private:
     void generateIcosphere(float radius, int subdivisions);
@@ -28,5 +30,7 @@ namespace model {
     GLuint glAttributesIdx;
     GLuint glBufferIdx;
     GLuint glIndexBufferIdx;
+
+    model::Submesh submesh;
   };
 }
@@ -37,6 +37,12 @@ model::Sphere::Sphere(float radius, int rings, int sectors) : radius(radius), ri
 
   glNamedBufferData(glBufferIdx, vertices.size() * sizeof(Vertex3D), vertices.data(), GL_STATIC_DRAW);
   glNamedBufferData(glIndexBufferIdx, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+  submesh = {/* clang-format off */
+    .firstIndex = 0,
+    .indexCount = static_cast<GLuint>(indices.size()),
+    .bounds = model::Bounds::fromIndexedVertices(vertices, indices)
+  }; /* clang-format on */
 }
 
 model::Sphere::~Sphere() {
@@ -45,9 +51,16 @@ model::Sphere::~Sphere() {
   glDeleteBuffers(1, &glIndexBufferIdx);
 }
 
-void model::Sphere::draw() const {
-  glBindVertexArray(glAttributesIdx);
-  glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+GLuint model::Sphere::getVertexArray() const {
+  return glAttributesIdx;
+}
+
+std::span<const model::Submesh> model::Sphere::getSubmeshes() const {
+  return {&submesh, 1};
+}
+
+const model::Bounds& model::Sphere::getBounds() const {
+  return submesh.bounds;
 }
 
 void model::Sphere::generateUVSphere(float radius, int rings, int sectors) {
@@ -13,7 +13,9 @@ namespace model {
   public:
     Sphere(float radius = 1.0f, int rings = 16, int sectors = 32);
     ~Sphere();
-    void draw() const;
+    [[nodiscard]] GLuint getVertexArray() const;
+    [[nodiscard]] std::span<const model::Submesh> getSubmeshes() const;
+    [[nodiscard]] const model::Bounds& getBounds() const;
 
   private:
     void generateUVSphere(float radius, int rings, int sectors);
@@ -28,5 +30,7 @@ namespace model {
     GLuint glAttributesIdx;
     GLuint glBufferIdx;
     GLuint glIndexBufferIdx;
+
+    model::Submesh submesh;
   };
 }
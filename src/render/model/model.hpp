@@ -1,11 +1,74 @@
 #pragma once
 
+#include <glad/gl.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <span>
+#include <glm/glm.hpp>
+
+#include "render/vertex.hpp"
+
+namespace model {
+  // Bounding sphere in model space, tested against the view frustum before anything is drawn
+  struct Bounds {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+
+    // Centered on the box around the referenced vertices, which fits the boxy meshes assets are mostly made of better
+    // than centering on their average
+    [[nodiscard]] static Bounds fromIndexedVertices(std::span<const Vertex3D> vertices,
+                                                    std::span<const GLuint> indices) noexcept {
+      if (indices.empty()) {
+        return {};
+      }
+
+      glm::vec3 min(std::numeric_limits<float>::max());
+      glm::vec3 max(std::numeric_limits<float>::lowest());
+      for (GLuint idx : indices) {
+        min = glm::min(min, vertices[idx].pos);
+        max = glm::max(max, vertices[idx].pos);
+      }
+
+      Bounds bounds = {.center = (min + max) * 0.5f};
+
+      float radiusSquared = 0.0f;
+      for (GLuint idx : indices) {
+        glm::vec3 offset = vertices[idx].pos - bounds.center;
+        radiusSquared = std::max(radiusSquared, glm::dot(offset, offset));
+      }
+
+      bounds.radius = std::sqrt(radiusSquared);
+      return bounds;
+    }
+  };
+
+  // A range of a model's index buffer drawn with a single material
+  struct Submesh {
+    GLuint firstIndex;
+    GLuint indexCount;
+
+    // Index into material::Manager3D's table, or nullopt to draw with the material of the entity the model belongs to
+    std::optional<GLuint> materialIdx;
+
+    // Of the vertices in the range
+    model::Bounds bounds;
+  };
+}
+
 class Model2D {
 public:
   virtual void draw() const = 0;
 };
 
+// 3D models are drawn by the renderer, which batches the submeshes of every model sharing a vertex array into
+// indirect draws
 class Model3D {
 public:
-  virtual void draw() const = 0;
+  [[nodiscard]] virtual GLuint getVertexArray() const = 0;
+  [[nodiscard]] virtual std::span<const model::Submesh> getSubmeshes() const = 0;
+
+  // Of the whole model, so entities can be culled before their submeshes are looked at
+  [[nodiscard]] virtual const model::Bounds& getBounds() const = 0;
 };
@@ -0,0 +1,61 @@
+#include "render-queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
+static constexpr uint64_t DEPTH_BITS = 29;
+
+// Non-negative floats order the same as their bits, so the top bits of those make an integer depth
+static uint64_t quantizeDepth(float depth) noexcept {
+  return std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> (31 - DEPTH_BITS);
+}
+
+uint64_t render::makeOpaqueSortKey(CullMode cullMode, GLuint vertexArrayIdx, GLuint materialIdx, float depth) noexcept {
+  /* clang-format off */
+  return (static_cast<uint64_t>(cullMode) << 61) |
+         (static_cast<uint64_t>(vertexArrayIdx & 0xFFFF) << 45) |
+         (static_cast<uint64_t>(materialIdx & 0xFFFF) << 29) |
+         quantizeDepth(depth); /* clang-format on */
+}
+
+uint64_t render::makeTranslucentSortKey(CullMode cullMode, GLuint vertexArrayIdx, GLuint materialIdx,
+                                        float depth) noexcept {
+  uint64_t farFirstDepth = ((1ull << DEPTH_BITS) - 1) - quantizeDepth(depth);
+
+  /* clang-format off */
+  return (1ull << 63) |
+         (farFirstDepth << 34) |
+         (static_cast<uint64_t>(cullMode) << 32) |
+         (static_cast<uint64_t>(vertexArrayIdx & 0xFFFF) << 16) |
+         static_cast<uint64_t>(materialIdx & 0xFFFF); /* clang-format on */
+}
+
+void render::sortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch) {
+  scratch.resize(entries.size());
+
+  for (int shift = 0; shift < 64; shift += 8) {
+    std::array<size_t, 256> offsets = {};
+    for (const auto& entry : entries) {
+      offsets[(entry.key >> shift) & 0xFF]++;
+    }
+
+    // Every key has the same byte here, so the pass wouldn't move anything
+    if (std::ranges::find(offsets, entries.size()) != offsets.end()) {
+      continue;
+    }
+
+    size_t offset = 0;
+    for (auto& count : offsets) {
+      size_t bucketSize = count;
+      count = offset;
+      offset += bucketSize;
+    }
+
+    for (const auto& entry : entries) {
+      scratch[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+    }
+
+    entries.swap(scratch);
+  }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+  enum class CullMode : uint8_t {
+    None,
+    Back,
+    Front
+  };
+
+  // Sort keys for the 3D draws of a frame. Sorting by key puts opaque draws first, grouped by the state they need and
+  // then front to back within it, followed by translucent draws back to front:
+  //
+  //   opaque       0 | cull mode (2) | vertex array (16) | material (16) | depth, near first (29)
+  //   translucent  1 | depth, far first (29) | cull mode (2) | vertex array (16) | material (16)
+  //
+  // Names wider than their field are truncated, which only makes sorting group their draws a little worse.
+  [[nodiscard]] uint64_t makeOpaqueSortKey(CullMode cullMode, GLuint vertexArrayIdx, GLuint materialIdx,
+                                           float depth) noexcept;
+  [[nodiscard]] uint64_t makeTranslucentSortKey(CullMode cullMode, GLuint vertexArrayIdx, GLuint materialIdx,
+                                                float depth) noexcept;
+
+  struct SortEntry {
+    uint64_t key;
+    uint32_t idx;
+  };
+
+  // Stable LSD radix sort a byte at a time, skipping bytes every key shares. Scratch is only kept to save allocating.
+  void sortEntries(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+
+  // What submitting the 3D draws of the last frame took
+  struct QueueStats {
+    size_t drawCount = 0;
+    size_t batchCount = 0;
+
+    // Changes between consecutive draws, over both passes with a depth pre-pass. Materials are read from a table, so
+    // changing them costs no GL calls, but fewer changes means better cache use on the GPU.
+    size_t cullStateChanges = 0;
+    size_t vertexArrayChanges = 0;
+    size_t depthMaskChanges = 0;
+    size_t materialChanges = 0;
+  };
+};
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/matrix.hpp>
+#include <algorithm>
+#include <limits>
 #include <print>
 #include <entt/entt.hpp>
 
@@ -22,25 +24,22 @@
 Renderer::Renderer(const std::shared_ptr<Window>& window,
                    const std::shared_ptr<entt::registry>& registry) /* clang-format off */
   : window(window), registry(registry),
+  frameData(std::make_shared<render::RingBuffer>(FRAME_DATA_REGION_SIZE)),
   // 3d
-  uniformProjMatrix3D(0),
-  uniformViewMatrix3D(1),
-  uniformModelMatrix3D(2),
   uniformTextureArray3D(3),
-  uniformCameraPos3D(4),
   // 3d - blocks
-  uniformLightsArray3D(0),
-  uniformMaterial3D(1),
+  uniformCamera3D(1, frameData),
+  uniformClusterGrid3D(0, frameData),
 
   // 2d
   uniformTextureArray2D(0),
   // 2d - blocks
-  uniformMaterial2D(0)
+  uniformMaterial2D(0, frameData)
 { /* clang-format on */
   cameraPos = constants::WORLD_ORIGIN;
   cameraFront = constants::WORLD_FORWARD;
 
-  projMatrix = glm::perspective(glm::radians(45.0f), ASPECT_RATIO, 0.05f, 10000.0f);
+  projMatrix = glm::perspective(glm::radians(45.0f), ASPECT_RATIO, NEAR_PLANE, FAR_PLANE);
   viewMatrix = glm::lookAt(cameraPos, cameraPos + cameraFront, constants::WORLD_UP);
 
   // Set initial viewport size with 16:9 aspect ratio
@@ -68,6 +67,18 @@ Renderer::Renderer(const std::shared_ptr<Window>& window,
 
   glViewport(viewportX, viewportY, viewportWidth, viewportHeight);
 
+  if (window->isHeadless()) {
+    glCreateRenderbuffers(1, &offscreenColorIdx);
+    glNamedRenderbufferStorage(offscreenColorIdx, GL_RGBA8, framebufferWidth, framebufferHeight);
+
+    glCreateRenderbuffers(1, &offscreenDepthIdx);
+    glNamedRenderbufferStorage(offscreenDepthIdx, GL_DEPTH_COMPONENT24, framebufferWidth, framebufferHeight);
+
+    glCreateFramebuffers(1, &offscreenFramebufferIdx);
+    glNamedFramebufferRenderbuffer(offscreenFramebufferIdx, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, offscreenColorIdx);
+    glNamedFramebufferRenderbuffer(offscreenFramebufferIdx, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, offscreenDepthIdx);
+  }
+
 #ifdef DEBUG
   glEnable(GL_DEBUG_OUTPUT);
 #endif
@@ -109,17 +120,49 @@ Renderer::Renderer(const std::shared_ptr<Window>& window,
     shader2D->link();
   }
 
+  {
+    // No fragment shader, as only depth is written
+    auto vertShader = std::make_unique<shader::Shader>(std::filesystem::path("shaders/depth.vert"), shader::Type::Vertex);
+
+    depthShader = std::make_unique<shader::Program>();
+    depthShader->addShader(std::move(vertShader));
+    depthShader->link();
+  }
+
+  {
+    auto compShader = std::make_unique<shader::Shader>(std::filesystem::path("shaders/cull.comp"), shader::Type::Compute);
+
+    cullShader = std::make_unique<shader::Program>();
+    cullShader->addShader(std::move(compShader));
+    cullShader->link();
+  }
+
   textureManager2D = std::make_shared<texture::Manager>(uniformTextureArray2D, 0);
   textureManager3D = std::make_shared<texture::Manager>(uniformTextureArray3D, 1);
 
   // todo: probably only store the uniform in the material manager itself
   materialManager2D = std::make_shared<material::Manager2D>(uniformMaterial2D, textureManager2D);
-  materialManager3D = std::make_shared<material::Manager3D>(uniformMaterial3D, textureManager3D);
+  materialManager3D = std::make_shared<material::Manager3D>(MATERIAL_TABLE_BINDING, textureManager3D);
 
-  // Need to activate shader program before setting uniforms
-  shader3D->use();
+  depthPyramid = std::make_unique<render::DepthPyramid>(DEPTH_PYRAMID_TEXTURE_UNIT);
+
+  gpuTimers = std::make_shared<render::GpuTimers>();
+  draw2DTimer = gpuTimers->addScope("draw2D");
+  draw3DTimer = gpuTimers->addScope("draw3D");
+  depthPyramidTimer = gpuTimers->addScope("depthPyramid");
+  presentTimer = gpuTimers->addScope("present");
 
-  uniformCameraPos3D.set(cameraPos);
+  glCreateBuffers(1, &visibleInstanceTableBufferIdx);
+}
+
+Renderer::~Renderer() {
+  glDeleteBuffers(1, &visibleInstanceTableBufferIdx);
+
+  if (offscreenFramebufferIdx != 0) {
+    glDeleteFramebuffers(1, &offscreenFramebufferIdx);
+    glDeleteRenderbuffers(1, &offscreenColorIdx);
+    glDeleteRenderbuffers(1, &offscreenDepthIdx);
+  }
 }
 
 asset::Material defaultMaterial3D = {
@@ -164,76 +207,431 @@ void Renderer::draw3D() {
 
   textureManager3D->bind();
 
-  uniformProjMatrix3D.set(projMatrix);
-  uniformViewMatrix3D.set(viewMatrix);
-  uniformCameraPos3D.set(cameraPos);
+  uniformCamera3D.set({.projMatrix = projMatrix, .viewMatrix = viewMatrix, .position = cameraPos});
 
-  auto lightEnts = registry->view<components::Position, components::Light>();
-  lightsArray.lightCount = 0;
+  lights.clear();
 
+  auto lightEnts = registry->view<components::Position, components::Light>();
   for (const auto ent : lightEnts) {
-    if (lightsArray.lightCount >= MAX_LIGHTS) {
-      break; // Prevent overflow
-    }
+    const auto& light = registry->get<components::Light>(ent);
+    const auto& position = registry->get<components::Position>(ent);
 
-    auto light = registry->get<components::Light>(ent);
-    auto position = registry->get<components::Position>(ent);
-
-    lightsArray.lights[lightsArray.lightCount++] = {/* clang-format off */
+    lights.push_back({/* clang-format off */
       .position = position.value,
-      .color = light.color * light.intensity,
-      .radius = light.radius
-    }; /* clang-format on */
+      .radius = light.radius,
+      .color = light.color * light.intensity
+    }); /* clang-format on */
   }
 
-  uniformLightsArray3D.set(lightsArray);
+  lightClusters.build(lights, viewMatrix, projMatrix, NEAR_PLANE);
+
+  GLint viewport[4];
+  glGetIntegerv(GL_VIEWPORT, viewport);
+  uniformClusterGrid3D.set(lightClusters.getGrid(glm::vec4(viewport[0], viewport[1], viewport[2], viewport[3])));
+
+  auto lightTableRange = frameData->write(lights.data(), sizeof(render::Light) * lights.size());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, LIGHT_TABLE_BINDING, lightTableRange);
+
+  auto clusterLights = lightClusters.getClusterLights();
+  auto clusterLightsRange = frameData->write(clusterLights.data(), clusterLights.size_bytes());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, CLUSTER_LIGHTS_BINDING, clusterLightsRange);
+
+  auto lightIndices = lightClusters.getLightIndices();
+  auto lightIndexListRange = frameData->write(lightIndices.data(), lightIndices.size_bytes());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_LIST_BINDING, lightIndexListRange);
+
+  frustum = render::Frustum::fromMatrix(projMatrix * viewMatrix);
+
+  gatherInstances();
+  buildDrawCommands();
+
+  materialManager3D->upload();
+  submitDrawCommands();
+
+  textureManager3D->unbind();
+}
+
+// Groups visible entities by model, material and cull state, and writes their model matrices into the instance table
+// group by group, in entity order within each
+void Renderer::gatherInstances() {
+  instanceGroups.clear();
+  instanceGroupIndices.clear();
+  ungroupedInstances.clear();
+  ungroupedInstanceKeys.clear();
+  ungroupedInstanceGroups.clear();
+
+  cullingStats = {};
 
   auto ents3d = registry->view<components::GlobalTransform, components::Model3D>();
   for (const auto ent : ents3d) {
-    auto globalTransform = registry->get<components::GlobalTransform>(ent);
-    auto model = registry->get<components::Model3D>(ent);
+    const auto& globalTransform = registry->get<components::GlobalTransform>(ent);
+    const auto& model = registry->get<components::Model3D>(ent);
 
-    asset::Material material = defaultMaterial3D;
+    const asset::Material* material = &defaultMaterial3D;
     if (registry->all_of<components::Material3D>(ent)) {
-      material = *registry->get<components::Material3D>(ent);
+      material = registry->get<components::Material3D>(ent).get();
     }
 
-    materialManager3D->setMaterial(material);
-
-    if (material.isDoubleSided) {
-      glDisable(GL_CULL_FACE);
-    } else {
-      glEnable(GL_CULL_FACE);
-
+    render::CullMode cullMode = render::CullMode::None;
+    if (!material->isDoubleSided) {
       // This doesn't currently work because:
       // - We transform vertices by the transforms provided by the gltf.
       // - Need to change the code so that transforms are stored and applied at runtime
       // - Potentially need to use glFrontFace?
       if (glm::determinant(globalTransform.value) < 0.0f) {
-        glCullFace(GL_BACK); // clockwise
+        cullMode = render::CullMode::Back; // clockwise
       } else {
-        glCullFace(GL_FRONT); // counter-clockwise (normal)
+        cullMode = render::CullMode::Front; // counter-clockwise (normal)
       }
     }
 
-    modelMatrix = globalTransform.value;
-    uniformModelMatrix3D.set(modelMatrix);
+    /* clang-format off */
+    render::InstanceGroupKey key = {
+      .model = model.get(),
+      .materialIdx = materialManager3D->getIndex(*material),
+      .cullMode = cullMode
+    }; /* clang-format on */
 
-    model->draw();
+    ungroupedInstances.push_back(globalTransform.value);
+    ungroupedInstanceKeys.push_back(key);
   }
 
-  textureManager3D->unbind();
+  // Whole instances first, so ones out of view never take up room in the instance table
+  cullingSpheres.resize(ungroupedInstances.size());
+  if (cullingMode == render::CullingMode::Cpu) {
+    for (size_t i = 0; i < ungroupedInstances.size(); ++i) {
+      cullingSpheres.set(i, ungroupedInstanceKeys[i].model->getBounds(), ungroupedInstances[i]);
+    }
+
+    render::testSpheres(frustum, cullingSpheres, 0, cullingSpheres.size());
+    cullingStats.testedInstances = ungroupedInstances.size();
+  } else {
+    std::ranges::fill(cullingSpheres.isVisible, 1);
+  }
+
+  ungroupedInstanceGroups.resize(ungroupedInstances.size());
+  for (size_t i = 0; i < ungroupedInstances.size(); ++i) {
+    if (!cullingSpheres.isVisible[i]) {
+      cullingStats.culledInstances++;
+      continue;
+    }
+
+    const auto& key = ungroupedInstanceKeys[i];
+    auto [groupIt, isNewGroup] = instanceGroupIndices.try_emplace(key, instanceGroups.size());
+    if (isNewGroup) {
+      instanceGroups.push_back({.model = key.model, .materialIdx = key.materialIdx, .cullMode = key.cullMode});
+    }
+
+    instanceGroups[groupIt->second].instanceCount++;
+    ungroupedInstanceGroups[i] = groupIt->second;
+  }
+
+  size_t instanceOffset = 0;
+  for (auto& group : instanceGroups) {
+    group.firstInstance = instanceOffset;
+    instanceOffset += group.instanceCount;
+    group.instanceCount = 0;
+  }
+
+  instanceTable.resize(ungroupedInstances.size() - cullingStats.culledInstances);
+  for (size_t i = 0; i < ungroupedInstances.size(); ++i) {
+    if (!cullingSpheres.isVisible[i]) {
+      continue;
+    }
+
+    auto& group = instanceGroups[ungroupedInstanceGroups[i]];
+    instanceTable[group.firstInstance + group.instanceCount++] = ungroupedInstances[i];
+  }
+}
+
+// One instanced command per submesh of every group, or per instance for translucent submeshes so they can be drawn
+// back to front. Commands are sorted by render::makeOpaqueSortKey and makeTranslucentSortKey, then batched by runs
+// sharing a vertex array, cull state and depth mask.
+void Renderer::buildDrawCommands() {
+  queuedDraws.clear();
+  sortEntries.clear();
+
+  // Along the view direction, to the center of a submesh's bounds
+  auto getViewDepth = [this](const glm::mat4x4& transform, const model::Bounds& bounds) {
+    return glm::dot(glm::vec3(transform * glm::vec4(bounds.center, 1.0f)) - cameraPos, cameraFront);
+  };
+
+  for (const auto& group : instanceGroups) {
+    GLuint vertexArrayIdx = group.model->getVertexArray();
+    auto submeshes = group.model->getSubmeshes();
+
+    // A lone instance of a model with several submeshes, like a level, is worth culling submesh by submesh. Doing
+    // the same for every instance of every submesh would cost more than drawing the few that end up out of view.
+    bool isCulledBySubmesh = cullingMode == render::CullingMode::Cpu && group.instanceCount == 1 && submeshes.size() > 1;
+    if (isCulledBySubmesh) {
+      cullingSpheres.resize(submeshes.size());
+      for (size_t i = 0; i < submeshes.size(); ++i) {
+        cullingSpheres.set(i, submeshes[i].bounds, instanceTable[group.firstInstance]);
+      }
+
+      render::testSpheres(frustum, cullingSpheres, 0, cullingSpheres.size());
+      cullingStats.testedSubmeshes += submeshes.size();
+    }
+
+    // Opaque commands drawing several instances sort by the nearest one
+    float nearestDepth = std::numeric_limits<float>::max();
+    if (group.instanceCount > 1) {
+      for (size_t i = 0; i < group.instanceCount; ++i) {
+        nearestDepth = std::min(nearestDepth, getViewDepth(instanceTable[group.firstInstance + i], group.model->getBounds()));
+      }
+    }
+
+    auto queueDraw = [&](const model::Submesh& submesh, size_t firstInstance, size_t instanceCount, float depth) {
+      render::QueuedDraw draw = {/* clang-format off */
+        .submesh = &submesh,
+        .vertexArrayIdx = vertexArrayIdx,
+        .materialIdx = submesh.materialIdx.value_or(group.materialIdx),
+        .cullMode = group.cullMode,
+        .firstInstance = static_cast<GLuint>(firstInstance),
+        .instanceCount = static_cast<GLuint>(instanceCount)
+      }; /* clang-format on */
+      draw.isTranslucent = materialManager3D->isTranslucent(draw.materialIdx);
+
+      uint64_t key = draw.isTranslucent
+                       ? render::makeTranslucentSortKey(draw.cullMode, vertexArrayIdx, draw.materialIdx, depth)
+                       : render::makeOpaqueSortKey(draw.cullMode, vertexArrayIdx, draw.materialIdx, depth);
+
+      sortEntries.push_back({.key = key, .idx = static_cast<uint32_t>(queuedDraws.size())});
+      queuedDraws.push_back(draw);
+    };
+
+    for (size_t i = 0; i < submeshes.size(); ++i) {
+      if (isCulledBySubmesh && !cullingSpheres.isVisible[i]) {
+        cullingStats.culledSubmeshes++;
+        continue;
+      }
+
+      const auto& submesh = submeshes[i];
+      if (group.instanceCount == 1) {
+        queueDraw(submesh, group.firstInstance, 1, getViewDepth(instanceTable[group.firstInstance], submesh.bounds));
+      } else if (!materialManager3D->isTranslucent(submesh.materialIdx.value_or(group.materialIdx))) {
+        queueDraw(submesh, group.firstInstance, group.instanceCount, nearestDepth);
+      } else {
+        for (size_t j = group.firstInstance; j < group.firstInstance + group.instanceCount; ++j) {
+          queueDraw(submesh, j, 1, getViewDepth(instanceTable[j], submesh.bounds));
+        }
+      }
+    }
+  }
+
+  render::sortEntries(sortEntries, sortScratch);
+
+  drawTable.resize(sortEntries.size());
+  drawCommands.resize(sortEntries.size());
+  drawBatches.clear();
+  cullTable.clear();
+  visibleInstanceCapacity = 0;
+  queueStats = {.drawCount = sortEntries.size()};
+
+  for (size_t i = 0; i < sortEntries.size(); ++i) {
+    const auto& draw = queuedDraws[sortEntries[i].idx];
+
+    drawCommands[i] = {/* clang-format off */
+      .count = draw.submesh->indexCount,
+      .instanceCount = draw.instanceCount,
+      .firstIndex = draw.submesh->firstIndex,
+      .baseVertex = 0,
+      .baseInstance = static_cast<GLuint>(i)
+    }; /* clang-format on */
+    drawTable[i] = {.firstInstance = draw.firstInstance, .materialIdx = draw.materialIdx};
+
+    if (cullingMode != render::CullingMode::Cpu) {
+      // Every command gets its own range of visible instances, as each submesh can be culled differently. The
+      // culling pass counts instances back up from zero.
+      cullTable.push_back({/* clang-format off */
+        .boundsCenter = draw.submesh->bounds.center,
+        .boundsRadius = draw.submesh->bounds.radius,
+        .firstInstance = draw.firstInstance,
+        .instanceCount = draw.instanceCount
+      }); /* clang-format on */
+
+      drawCommands[i].instanceCount = 0;
+      drawTable[i].firstInstance = static_cast<GLuint>(visibleInstanceCapacity);
+      visibleInstanceCapacity += draw.instanceCount;
+    }
+
+    if (i > 0 && drawTable[i - 1].materialIdx != draw.materialIdx) {
+      queueStats.materialChanges++;
+    }
+
+    bool isNewBatch = drawBatches.empty() || drawBatches.back().vertexArrayIdx != draw.vertexArrayIdx ||
+                      drawBatches.back().cullMode != draw.cullMode ||
+                      drawBatches.back().isTranslucent != draw.isTranslucent;
+    if (isNewBatch) {
+      /* clang-format off */
+      drawBatches.push_back({
+        .vertexArrayIdx = draw.vertexArrayIdx,
+        .cullMode = draw.cullMode,
+        .isTranslucent = draw.isTranslucent,
+        .firstCommand = i
+      }); /* clang-format on */
+    }
+
+    drawBatches.back().commandCount++;
+  }
+}
+
+void Renderer::submitDrawCommands() {
+  auto instanceTableRange = frameData->write(instanceTable.data(), sizeof(glm::mat4x4) * instanceTable.size());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, INSTANCE_TABLE_BINDING, instanceTableRange);
+
+  auto drawTableRange = frameData->write(drawTable.data(), sizeof(render::DrawData) * drawTable.size());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, DRAW_TABLE_BINDING, drawTableRange);
+
+  auto drawCommandRange = frameData->write(drawCommands.data(), sizeof(render::DrawCommand) * drawCommands.size());
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, drawCommandRange.bufferIdx);
+
+  if (cullingMode != render::CullingMode::Cpu) {
+    cullDrawCommandsOnGpu(drawCommandRange);
+  }
+
+  queueStats.batchCount = drawBatches.size();
+
+  if (hasDepthPrePass) {
+    // Opaque draws fill in depth with a position-only shader first, so the colour pass only shades the fragments that
+    // end up visible
+    depthShader->use();
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    submitBatches(drawCommandRange, true);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    shader3D->use();
+
+    glDepthFunc(GL_EQUAL);
+    glDepthMask(GL_FALSE);
+  }
+
+  submitBatches(drawCommandRange, false);
+
+  glDepthFunc(GL_LESS);
+  glDepthMask(GL_TRUE);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+// Draws every batch, or only the opaque ones for the depth pre-pass. Translucent batches always come last.
+void Renderer::submitBatches(const render::RingAllocation& drawCommandRange, bool isDepthPrePass) {
+  // State is only changed between batches that differ in it, and the first batch sets everything
+  const render::DrawBatch* previousBatch = nullptr;
+  for (const auto& batch : drawBatches) {
+    if (batch.isTranslucent && (!previousBatch || !previousBatch->isTranslucent)) {
+      if (isDepthPrePass) {
+        break;
+      }
+
+      // Translucent draws are tested against the depth of opaque ones, but don't hide each other
+      glDepthFunc(GL_LESS);
+      glDepthMask(GL_FALSE);
+      queueStats.depthMaskChanges++;
+    }
+
+    if (!previousBatch || previousBatch->cullMode != batch.cullMode) {
+      if (batch.cullMode == render::CullMode::None) {
+        glDisable(GL_CULL_FACE);
+      } else {
+        glEnable(GL_CULL_FACE);
+        glCullFace(batch.cullMode == render::CullMode::Back ? GL_BACK : GL_FRONT);
+      }
+
+      queueStats.cullStateChanges++;
+    }
+
+    if (!previousBatch || previousBatch->vertexArrayIdx != batch.vertexArrayIdx) {
+      glBindVertexArray(batch.vertexArrayIdx);
+      queueStats.vertexArrayChanges++;
+    }
+
+    /* clang-format off */
+    glMultiDrawElementsIndirect(
+      GL_TRIANGLES,
+      GL_UNSIGNED_INT,
+      reinterpret_cast<const void*>(drawCommandRange.offset + batch.firstCommand * sizeof(render::DrawCommand)),
+      static_cast<GLsizei>(batch.commandCount),
+      0
+    ); /* clang-format on */
+
+    previousBatch = &batch;
+  }
+}
+
+// Copies the instances of each command that are in view to the command's range of the visible instance table, and
+// counts them into its instanceCount. The 3D shaders then read the visible table in place of the instance table.
+void Renderer::cullDrawCommandsOnGpu(const render::RingAllocation& drawCommandRange) {
+  auto cullTableRange = frameData->write(cullTable.data(), sizeof(render::CullData) * cullTable.size());
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, CULL_TABLE_BINDING, cullTableRange);
+
+  /* clang-format off */
+  glNamedBufferData(
+    visibleInstanceTableBufferIdx,
+    sizeof(glm::mat4x4) * visibleInstanceCapacity,
+    nullptr,
+    GL_STREAM_DRAW
+  ); /* clang-format on */
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VISIBLE_INSTANCE_TABLE_BINDING, visibleInstanceTableBufferIdx);
+  render::RingBuffer::bindRange(GL_SHADER_STORAGE_BUFFER, DRAW_COMMAND_BINDING, drawCommandRange);
+
+  cullShader->use();
+  glUniform4fv(0, static_cast<GLsizei>(frustum.planes.size()), &frustum.planes[0][0]);
+
+  bool isOcclusionTested = cullingMode == render::CullingMode::GpuOcclusion && depthPyramid->isBuilt();
+  glUniform1i(7, isOcclusionTested);
+  if (isOcclusionTested) {
+    glUniformMatrix4fv(8, 1, GL_FALSE, &depthPyramid->getViewProjMatrix()[0][0]);
+    glBindTextureUnit(DEPTH_PYRAMID_TEXTURE_UNIT, depthPyramid->getTextureIdx());
+  }
+
+  // One work group per command
+  for (size_t firstCommand = 0; firstCommand < drawCommands.size(); firstCommand += MAX_CULL_WORK_GROUPS) {
+    glUniform1ui(6, static_cast<GLuint>(firstCommand));
+    glDispatchCompute(static_cast<GLuint>(std::min(drawCommands.size() - firstCommand, MAX_CULL_WORK_GROUPS)), 1, 1);
+  }
+
+  glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+  glBindTextureUnit(DEPTH_PYRAMID_TEXTURE_UNIT, 0);
+
+  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_TABLE_BINDING, visibleInstanceTableBufferIdx);
+  shader3D->use();
 }
 
 void Renderer::drawFrame() {
+  frameData->beginFrame();
+  gpuTimers->beginFrame();
+
+  glBindFramebuffer(GL_FRAMEBUFFER, offscreenFramebufferIdx);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // Clear the depth buffer
 
   // todo: make it more clear this is a skybox stage
   glDisable(GL_DEPTH_TEST);
+  gpuTimers->begin(draw2DTimer);
   draw2D();
+  gpuTimers->end(draw2DTimer);
   glEnable(GL_DEPTH_TEST);
 
+  gpuTimers->begin(draw3DTimer);
   draw3D();
+  gpuTimers->end(draw3DTimer);
+
+  // Next frame's occlusion culling tests against what this one drew
+  if (cullingMode == render::CullingMode::GpuOcclusion) {
+    gpuTimers->begin(depthPyramidTimer);
+    depthPyramid->build(projMatrix * viewMatrix);
+    gpuTimers->end(depthPyramidTimer);
+  }
+
+  frameData->endFrame();
+}
+
+void Renderer::present() {
+  gpuTimers->begin(presentTimer);
+  if (window->isHeadless()) {
+    glFinish(); // Nothing to present
+  } else {
+    glfwSwapBuffers(window->getGlfwWindow());
+  }
+  gpuTimers->end(presentTimer);
 }
 
 void Renderer::setCameraPos(const glm::vec3& cameraPos) noexcept {
@@ -250,6 +648,31 @@ const glm::vec3& Renderer::getCameraPos() const noexcept {
   return cameraPos;
 }
 
+const render::CullingStats& Renderer::getCullingStats() const noexcept {
+  return cullingStats;
+}
+
+const render::QueueStats& Renderer::getQueueStats() const noexcept {
+  return queueStats;
+}
+
+const std::shared_ptr<render::GpuTimers>& Renderer::getGpuTimers() const noexcept {
+  return gpuTimers;
+}
+
+void Renderer::setDepthPrePass(bool hasDepthPrePass) noexcept {
+  this->hasDepthPrePass = hasDepthPrePass;
+}
+
+bool Renderer::isDepthPrePassEnabled() const noexcept {
+  return hasDepthPrePass;
+}
+
+void Renderer::setCullingMode(render::CullingMode cullingMode) noexcept {
+  this->cullingMode = cullingMode;
+  depthPyramid->reset();
+}
+
 std::shared_ptr<model::Asset> Renderer::createAsset3D(const asset::Asset3D& asset) const {
   return std::make_shared<model::Asset>(asset, textureManager3D, materialManager3D);
 }
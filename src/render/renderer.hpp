@@ -3,6 +3,8 @@
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <entt/entt.hpp>
 
@@ -14,36 +16,173 @@
 #include "render/material/material2d.hpp"
 #include "render/material/material3d.hpp"
 #include "render/model/3d/asset.hpp"
+#include "render/frustum.hpp"
+#include "render/depth-pyramid.hpp"
+#include "render/gpu-timers.hpp"
+#include "render/light-clusters.hpp"
+#include "render/render-queue.hpp"
+#include "render/ring-buffer.hpp"
 #include "render/shader/program.hpp"
 
-#define MAX_LIGHTS 40
-
 namespace render {
-  struct Light {
+  // Laid out as std140
+  struct Camera {
+    glm::mat4x4 projMatrix;
+    glm::mat4x4 viewMatrix;
     alignas(16) glm::vec3 position;
-    alignas(16) glm::vec3 color;
-    float radius;
   };
 
-  struct LightsArray {
-    GLuint lightCount;
-    Light lights[MAX_LIGHTS];
+  // What the 3D shaders read for each draw command, at gl_BaseInstance. Instances of the command read their model
+  // matrix from the instance table at firstInstance + gl_InstanceID.
+  struct DrawData {
+    GLuint firstInstance;
+    GLuint materialIdx;
+  };
+
+  // Laid out as glMultiDrawElementsIndirect reads it
+  struct DrawCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+  };
+
+  // Entities drawing the same model with the same material and cull state. They're drawn as instances of a single
+  // command per submesh.
+  struct InstanceGroup {
+    const Model3D* model;
+    GLuint materialIdx;
+    CullMode cullMode;
+    size_t firstInstance = 0;
+    size_t instanceCount = 0;
+  };
+
+  struct InstanceGroupKey {
+    const Model3D* model;
+    GLuint materialIdx;
+    CullMode cullMode;
+
+    bool operator==(const InstanceGroupKey&) const = default;
+  };
+
+  struct InstanceGroupKeyHash {
+    size_t operator()(const InstanceGroupKey& key) const noexcept {
+      size_t state = (static_cast<size_t>(key.materialIdx) << 2) | static_cast<size_t>(key.cullMode);
+      return std::hash<const void*>{}(key.model) ^ (state * 0x9E3779B97F4A7C15ull);
+    }
+  };
+
+  // What the GPU culling pass reads for each draw command, alongside its DrawData. Laid out as std430.
+  struct CullData {
+    glm::vec3 boundsCenter;
+    float boundsRadius;
+
+    // Where the command's instances are in the instance table. Visible ones are copied to the range DrawData points at.
+    GLuint firstInstance;
+    GLuint instanceCount;
+    GLuint _padding[2];
+  };
+
+  enum class CullingMode : uint8_t {
+    // Tested in draw3D, before commands are built
+    Cpu,
+    // Every command is built with all of its instances, and a compute pass drops the ones out of view
+    Gpu,
+    // Same, also dropping instances hidden behind the depth of the frame before. Instances coming out from behind
+    // something show up a frame late.
+    GpuOcclusion
+  };
+
+  // Frustum culling counts of the last frame. Instances are tested whole, then lone instances of models with several
+  // submeshes are tested submesh by submesh. Only counted with CPU culling, as GPU culling never reads its results back.
+  struct CullingStats {
+    size_t testedInstances = 0;
+    size_t culledInstances = 0;
+    size_t testedSubmeshes = 0;
+    size_t culledSubmeshes = 0;
+  };
+
+  static_assert(sizeof(CullData) == 32);
+
+  // A submesh drawn for a range of the instance table, waiting to be sorted into place
+  struct QueuedDraw {
+    const model::Submesh* submesh;
+    GLuint vertexArrayIdx;
+    GLuint materialIdx;
+    CullMode cullMode;
+    bool isTranslucent;
+    GLuint firstInstance;
+    GLuint instanceCount;
+  };
+
+  // Consecutive sorted commands sharing a vertex array, cull state and depth mask, submitted with a single
+  // glMultiDrawElementsIndirect
+  struct DrawBatch {
+    GLuint vertexArrayIdx;
+    CullMode cullMode;
+    bool isTranslucent;
+    size_t firstCommand = 0;
+    size_t commandCount = 0;
   };
 }
 
 class Renderer final {
 public:
   Renderer(const std::shared_ptr<Window>& window, const std::shared_ptr<entt::registry>& registry);
+  ~Renderer();
 
   // 16:9 aspect ratio constant
   static constexpr float ASPECT_RATIO = 16.0f / 9.0f;
 
+  // Of the 3D projection
+  static constexpr float NEAR_PLANE = 0.05f;
+  static constexpr float FAR_PLANE = 10000.0f;
+
+  // Shader storage bindings of the 3D shaders
+  static constexpr GLuint MATERIAL_TABLE_BINDING = 0;
+  static constexpr GLuint DRAW_TABLE_BINDING = 1;
+  static constexpr GLuint INSTANCE_TABLE_BINDING = 2;
+  static constexpr GLuint LIGHT_TABLE_BINDING = 6;
+  static constexpr GLuint CLUSTER_LIGHTS_BINDING = 7;
+  static constexpr GLuint LIGHT_INDEX_LIST_BINDING = 8;
+
+  // Further bindings of the culling pass
+  static constexpr GLuint CULL_TABLE_BINDING = 3;
+  static constexpr GLuint VISIBLE_INSTANCE_TABLE_BINDING = 4;
+  static constexpr GLuint DRAW_COMMAND_BINDING = 5;
+
+  // Bytes of frame data each frame in flight starts out with room for. Grown when a frame needs more.
+  static constexpr size_t FRAME_DATA_REGION_SIZE = 1 << 20;
+
+  // Texture unit the culling pass samples the depth pyramid from
+  static constexpr GLuint DEPTH_PYRAMID_TEXTURE_UNIT = 2;
+
+  // Work groups the culling pass is dispatched in at most, the least GL guarantees
+  static constexpr size_t MAX_CULL_WORK_GROUPS = 65535;
+
   void drawFrame();
 
+  // Swaps buffers, or for a headless window waits for the frame to finish so frame times stay honest
+  void present();
+
   void setCameraPos(const glm::vec3& cameraPos) noexcept;
   void setCameraDir(const glm::vec3& cameraDir) noexcept;
 
   [[nodiscard]] const glm::vec3& getCameraPos() const noexcept;
+  [[nodiscard]] const render::CullingStats& getCullingStats() const noexcept;
+  [[nodiscard]] const render::QueueStats& getQueueStats() const noexcept;
+
+  // GPU time of draw2D, draw3D, the depth pyramid build and present, each timed on its own. Others may add scopes to
+  // time the rest of the frame, as long as they don't overlap these.
+  [[nodiscard]] const std::shared_ptr<render::GpuTimers>& getGpuTimers() const noexcept;
+
+  void setCullingMode(render::CullingMode cullingMode) noexcept;
+
+  // Draws opaque 3D geometry depth-only before shading it, trading a second geometry pass for shading each pixel once.
+  // Worth it where many surfaces overlap on screen.
+  void setDepthPrePass(bool hasDepthPrePass) noexcept;
+  [[nodiscard]] bool isDepthPrePassEnabled() const noexcept;
 
   [[nodiscard]] std::shared_ptr<model::Asset> createAsset3D(const asset::Asset3D& asset) const;
 
@@ -54,20 +193,26 @@ private:
   void draw3D();
   void draw2D();
 
+  // Steps of draw3D
+  void gatherInstances();
+  void buildDrawCommands();
+  void submitDrawCommands();
+  void submitBatches(const render::RingAllocation& drawCommandRange, bool isDepthPrePass);
+  void cullDrawCommandsOnGpu(const render::RingAllocation& drawCommandRange);
+
   // todo: this is a mess, separate 2d and 3d into structs
   std::shared_ptr<material::Manager2D> materialManager2D;
   std::shared_ptr<material::Manager3D> materialManager3D;
 
   std::shared_ptr<entt::registry> registry;
 
+  // Everything sent to the GPU anew every frame. Declared before the uniform blocks writing to it.
+  std::shared_ptr<render::RingBuffer> frameData;
+
   // 3d uniforms
-  uniform::Single<glm::mat4x4> uniformProjMatrix3D;
-  uniform::Single<glm::mat4x4> uniformViewMatrix3D;
-  uniform::Single<glm::mat4x4> uniformModelMatrix3D;
   uniform::Single<GLint> uniformTextureArray3D;
-  uniform::Single<glm::vec3> uniformCameraPos3D;
-  uniform::Block<render::LightsArray> uniformLightsArray3D;
-  uniform::Block<material::Material3D> uniformMaterial3D;
+  uniform::Block<render::Camera> uniformCamera3D;
+  uniform::Block<render::ClusterGrid> uniformClusterGrid3D;
 
   // 2d uniforms
   uniform::Single<GLint> uniformTextureArray2D;
@@ -75,14 +220,61 @@ private:
 
   glm::mat4x4 projMatrix;
   glm::mat4x4 viewMatrix;
-  glm::mat4x4 modelMatrix;
 
-  render::LightsArray lightsArray;
+  // Rebuilt every frame by draw3D
+  std::vector<render::Light> lights;
+  render::LightClusters lightClusters;
+
+  // Of projMatrix * viewMatrix, updated by draw3D
+  render::Frustum frustum;
+  render::SphereBatch cullingSpheres;
+  render::CullingStats cullingStats;
+  render::CullingMode cullingMode = render::CullingMode::Cpu;
+  bool hasDepthPrePass = false;
+  std::unique_ptr<render::DepthPyramid> depthPyramid;
+
+  std::shared_ptr<render::GpuTimers> gpuTimers;
+  size_t draw2DTimer;
+  size_t draw3DTimer;
+  size_t depthPyramidTimer;
+  size_t presentTimer;
+
+  // Rebuilt every frame by draw3D. Instances are gathered in entity order, then the visible ones are laid out group by
+  // group.
+  std::vector<render::InstanceGroup> instanceGroups;
+  std::unordered_map<render::InstanceGroupKey, size_t, render::InstanceGroupKeyHash> instanceGroupIndices;
+  std::vector<glm::mat4x4> ungroupedInstances;
+  std::vector<render::InstanceGroupKey> ungroupedInstanceKeys;
+  std::vector<size_t> ungroupedInstanceGroups;
+  std::vector<glm::mat4x4> instanceTable;
+
+  // Likewise for commands, queued in group order then laid out in sort key order
+  std::vector<render::QueuedDraw> queuedDraws;
+  std::vector<render::SortEntry> sortEntries;
+  std::vector<render::SortEntry> sortScratch;
+  std::vector<render::DrawData> drawTable;
+  std::vector<render::DrawBatch> drawBatches;
+  std::vector<render::DrawCommand> drawCommands;
+  render::QueueStats queueStats;
+
+  // Parallel to the draw table, only filled in with GPU culling
+  std::vector<render::CullData> cullTable;
+  size_t visibleInstanceCapacity = 0;
+
+  // Only written by the culling pass, so kept out of the frame data
+  GLuint visibleInstanceTableBufferIdx = 0;
 
   glm::vec3 cameraPos;
   glm::vec3 cameraFront;
 
+  // Headless windows have no default framebuffer, so frames are drawn here instead
+  GLuint offscreenFramebufferIdx = 0;
+  GLuint offscreenColorIdx = 0;
+  GLuint offscreenDepthIdx = 0;
+
   std::shared_ptr<Window> window;
   std::unique_ptr<shader::Program> shader3D;
   std::unique_ptr<shader::Program> shader2D;
+  std::unique_ptr<shader::Program> depthShader;
+  std::unique_ptr<shader::Program> cullShader;
 };
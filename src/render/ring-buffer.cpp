@@ -0,0 +1,106 @@
+#include "ring-buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+render::RingBuffer::RingBuffer(size_t regionSize) : regionSize(regionSize) {
+  GLint uniformAlignment, storageAlignment;
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+  alignment = static_cast<size_t>(std::max({uniformAlignment, storageAlignment, 16}));
+
+  createBuffer();
+}
+
+render::RingBuffer::~RingBuffer() {
+  for (GLsync fence : fences) {
+    glDeleteSync(fence);
+  }
+
+  for (const auto& retired : retiredBuffers) {
+    glDeleteBuffers(1, &retired.bufferIdx);
+  }
+
+  // Unmaps it too
+  glDeleteBuffers(1, &bufferIdx);
+}
+
+void render::RingBuffer::createBuffer() {
+  constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+  GLsizeiptr size = static_cast<GLsizeiptr>(regionSize * FRAMES_IN_FLIGHT);
+
+  glCreateBuffers(1, &bufferIdx);
+  glNamedBufferStorage(bufferIdx, size, nullptr, flags);
+  mappedData = static_cast<std::byte*>(glMapNamedBufferRange(bufferIdx, 0, size, flags));
+}
+
+void render::RingBuffer::beginFrame() {
+  GLsync& fence = fences[frame % FRAMES_IN_FLIGHT];
+  if (fence) {
+    // Only flushed on the first wait, as the fence has been queued by then
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (glClientWaitSync(fence, waitFlags, std::numeric_limits<GLuint64>::max()) == GL_TIMEOUT_EXPIRED) {
+      waitFlags = 0;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+  // The frames that used these have now finished
+  std::erase_if(retiredBuffers, [this](const RetiredBuffer& retired) {
+    if (retired.frame + FRAMES_IN_FLIGHT > frame) {
+      return false;
+    }
+
+    glDeleteBuffers(1, &retired.bufferIdx);
+    return true;
+  });
+
+  regionUsed = 0;
+}
+
+void render::RingBuffer::endFrame() {
+  fences[frame % FRAMES_IN_FLIGHT] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  ++frame;
+}
+
+render::RingAllocation render::RingBuffer::allocate(size_t size) {
+  // Ranges can't be empty when bound
+  size_t alignedSize = (std::max<size_t>(size, 1) + alignment - 1) / alignment * alignment;
+
+  if (regionUsed + alignedSize > regionSize) {
+    // Nothing reads the new buffer yet, so the frame can start on it straight away
+    retiredBuffers.push_back({.bufferIdx = bufferIdx, .frame = frame});
+    glUnmapNamedBuffer(bufferIdx);
+
+    regionSize = std::max(regionSize * 2, alignedSize);
+    regionUsed = 0;
+    createBuffer();
+  }
+
+  size_t offset = (frame % FRAMES_IN_FLIGHT) * regionSize + regionUsed;
+  regionUsed += alignedSize;
+
+  /* clang-format off */
+  return {
+    .bufferIdx = bufferIdx,
+    .offset = static_cast<GLintptr>(offset),
+    .size = static_cast<GLsizeiptr>(alignedSize),
+    .data = mappedData + offset
+  }; /* clang-format on */
+}
+
+render::RingAllocation render::RingBuffer::write(const void* data, size_t size) {
+  RingAllocation allocation = allocate(size);
+  if (size > 0) {
+    std::memcpy(allocation.data, data, size);
+  }
+
+  return allocation;
+}
+
+void render::RingBuffer::bindRange(GLenum target, GLuint binding, const RingAllocation& allocation) {
+  glBindBufferRange(target, binding, allocation.bufferIdx, allocation.offset, allocation.size);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glad/gl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+  // A range of a RingBuffer, written through data. Valid until the end of the frame it was allocated in.
+  struct RingAllocation {
+    GLuint bufferIdx;
+    GLintptr offset;
+    GLsizeiptr size;
+    std::byte* data;
+  };
+
+  // Per-frame data written straight into persistently mapped memory. The buffer is split into a region per frame in
+  // flight, and a region is only written again once the fence of the frame that last used it has signalled, so the
+  // driver never has to stall or copy to keep data the GPU is still reading intact.
+  class RingBuffer {
+  public:
+    static constexpr size_t FRAMES_IN_FLIGHT = 3;
+
+    explicit RingBuffer(size_t regionSize);
+    ~RingBuffer();
+
+    // Waits for the GPU to be done with the region this frame writes to
+    void beginFrame();
+
+    // Fences the region, once every command reading it has been issued
+    void endFrame();
+
+    // Aligned for use as any uniform or shader storage range. A full region is grown into a new buffer, leaving
+    // earlier allocations of the frame where they are.
+    [[nodiscard]] RingAllocation allocate(size_t size);
+    [[nodiscard]] RingAllocation write(const void* data, size_t size);
+
+    static void bindRange(GLenum target, GLuint binding, const RingAllocation& allocation);
+
+  private:
+    struct RetiredBuffer {
+      GLuint bufferIdx;
+      uint64_t frame;
+    };
+
+    void createBuffer();
+
+    GLuint bufferIdx = 0;
+    std::byte* mappedData = nullptr;
+    size_t regionSize;
+    size_t regionUsed = 0;
+    size_t alignment;
+
+    std::array<GLsync, FRAMES_IN_FLIGHT> fences = {};
+    uint64_t frame = 0;
+
+    // Outgrown buffers, deleted once the last frame that used them is done
+    std::vector<RetiredBuffer> retiredBuffers;
+  };
+};
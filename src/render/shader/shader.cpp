@@ -15,6 +15,8 @@ uint32_t shader::shaderTypeToGLType(const shader::Type type) {
     return GL_VERTEX_SHADER;
   case shader::Type::Fragment:
     return GL_FRAGMENT_SHADER;
+  case shader::Type::Compute:
+    return GL_COMPUTE_SHADER;
   }
 
   std::unreachable();
@@ -7,7 +7,8 @@
 namespace shader {
   enum class Type {
     Vertex,
-    Fragment
+    Fragment,
+    Compute
   };
 
   uint32_t shaderTypeToGLType(const shader::Type type);
@@ -16,6 +16,8 @@ namespace texture {
     GLint index = -1;
     float uvRotation = 0.0f;
     float _padding[2];
+
+    bool operator==(const Texture&) const = default;
   };
 
   static_assert(sizeof(texture::Texture) % 16 == 0, "Ensure Texture is std140 compliant");
@@ -6,17 +6,16 @@
 #include "render/material/material2d.hpp"
 #include "render/material/material3d.hpp"
 
-template <typename T> uniform::Block<T>::Block(const GLint location) : location(location) {
-  glCreateBuffers(1, &bufferIdx);
-  glNamedBufferStorage(bufferIdx, sizeof(T), nullptr, GL_DYNAMIC_STORAGE_BIT);
+template <typename T>
+uniform::Block<T>::Block(const GLint location, std::shared_ptr<render::RingBuffer> ringBuffer)
+    : location(location), ringBuffer(std::move(ringBuffer)) {
 }
 
 template <typename T> void uniform::Block<T>::set(const T& value) const {
-  glBindBufferBase(GL_UNIFORM_BUFFER, location, bufferIdx);
-  glNamedBufferSubData(bufferIdx, 0, sizeof(T), &value);
+  render::RingBuffer::bindRange(GL_UNIFORM_BUFFER, location, ringBuffer->write(&value, sizeof(T)));
 }
 
-template class uniform::Block<render::LightsArray>;
+template class uniform::Block<render::Camera>;
+template class uniform::Block<render::ClusterGrid>;
 
 template class uniform::Block<material::Material2D>;
-template class uniform::Block<material::Material3D>;
@@ -1,14 +1,19 @@
 #pragma once
 
 #include <glad/gl.h>
+#include <memory>
+
+#include "render/ring-buffer.hpp"
 
 namespace uniform {
+  // Every set writes a fresh range of the ring buffer, so a value is never overwritten while a draw reading it is
+  // still in flight
   template <typename T> class Block {
   public:
-    Block(const GLint location);
+    Block(const GLint location, std::shared_ptr<render::RingBuffer> ringBuffer);
     void set(const T& value) const;
 
     GLint location;
-    GLuint bufferIdx;
+    std::shared_ptr<render::RingBuffer> ringBuffer;
   };
 }
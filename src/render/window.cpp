@@ -1,13 +1,23 @@
 #include "window.hpp"
 
-Window::Window(uint16_t width, uint16_t height, std::string title)
-    : currentWidth(width), currentHeight(height), currentTitle(title) {
+Window::Window(uint16_t width, uint16_t height, std::string title, bool isHeadless)
+    : currentWidth(width), currentHeight(height), currentTitle(title), headless(isHeadless) {
 
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
   glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+  if (isHeadless) {
+    // EGL lets Mesa hand out a context without any surface (EGL_MESA_platform_surfaceless)
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+  }
+
   glfwWindow = glfwCreateWindow(width, height, title.c_str(), nullptr, nullptr);
+  if (!glfwWindow) {
+    return;
+  }
+
   glfwSetWindowUserPointer(glfwWindow, this);
   glfwMakeContextCurrent(glfwWindow);
   glfwSetInputMode(glfwWindow, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
@@ -49,6 +59,10 @@ void Window::onResize(GLFWwindow* window, int width, int height) {
   glViewport(viewportX, viewportY, viewportWidth, viewportHeight);
 }
 
+bool Window::isHeadless() const {
+  return headless;
+}
+
 bool Window::shouldClose() const {
   return glfwWindowShouldClose(glfwWindow) == GL_TRUE;
 }
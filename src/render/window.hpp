@@ -7,7 +7,8 @@
 
 class Window final {
 public:
-  Window(const uint16_t width, const uint16_t height, const std::string title);
+  // Headless windows are never shown and get a surfaceless context, see plugins::Render
+  Window(const uint16_t width, const uint16_t height, const std::string title, const bool isHeadless = false);
   ~Window();
 
   [[nodiscard]] GLFWwindow* getGlfwWindow() const;
@@ -16,11 +17,13 @@ public:
   [[nodiscard]] std::string& getTitle() const;
 
   [[nodiscard]] bool shouldClose() const;
+  [[nodiscard]] bool isHeadless() const;
 
 private:
   uint16_t currentWidth;
   int currentHeight;
   std::string currentTitle;
+  bool headless;
 
   GLFWwindow* glfwWindow;
 
@@ -1,9 +1,22 @@
 #pragma once
 
+#include <cstdint>
+
 namespace resources {
   struct Time {
-    float deltaTime;
-    float currentTime;
-    float lastTime;
+    float deltaTime = 0.0f;
+    float currentTime = 0.0f;
+    float lastTime = 0.0f;
+
+    // Schedule::FixedUpdate (after Schedule::PreFixedUpdate) runs every fixedDeltaTime seconds, as many times per frame
+    // as the accumulator allows
+    float fixedDeltaTime = 1.0f / 60.0f;
+    float fixedAccumulator = 0.0f;
+
+    // Past this many steps in one frame the remaining backlog is dropped, so a slow frame can't snowball
+    uint32_t maxFixedStepsPerFrame = 8;
+
+    // How far the current frame is between the last two fixed steps, in [0, 1)
+    float fixedAlpha = 0.0f;
   };
 };
@@ -26,7 +26,10 @@
 
 #include "render/renderer.hpp"
 
+#include "plugins/physics/mesh-bvh.hpp"
+
 #include "util/error.hpp"
+#include "util/thread-pool.hpp"
 
 #include "constants.hpp"
 
@@ -107,14 +110,10 @@ static void createLightsForEmissiveMaterials(const asset::Asset3D& cityAsset, st
 
 static std::expected<void, std::string> startup(/* clang-format off */
   std::shared_ptr<entt::registry> registry,
-  std::shared_ptr<Renderer> renderer
+  std::shared_ptr<Renderer> renderer,
+  std::shared_ptr<scenes::nfs::resources::Models> models,
+  Read<std::shared_ptr<util::ThreadPool>> pool
 ) {
-  { // baseplate 1000x1000 (invisible)
-    auto baseplateEnt = registry->create();
-    registry->emplace<components::Position>(baseplateEnt, glm::vec3(0.0f, 0.0f, -0.2f));
-    registry->emplace<components::BoxCollider>(baseplateEnt, glm::vec3(500.0f, 500.0f, 0.05f));
-  }
-
   {
     auto asset = asset::loader::Gltf::tryFromFile("resources/CarConcept/CarConcept.gltf", *renderer->textureManager3D);
     if (!asset.has_value()) {
@@ -133,6 +132,7 @@ static std::expected<void, std::string> startup(/* clang-format off */
 
     auto ent = registry->create();
     registry->emplace<components::Position>(ent, glm::vec3(0.0f, 0.0f, 0.0f));
+    registry->emplace<components::Rotation>(ent, glm::quat(1.0f, 0.0f, 0.0f, 0.0f));
     registry->emplace<components::Model3D>(ent, model);
 
     registry->emplace<components::Velocity>(ent, glm::vec3(0.0f, 0.0f, 0.0f));
@@ -154,6 +154,10 @@ static std::expected<void, std::string> startup(/* clang-format off */
     registry->emplace<components::Scale>(ent, glm::vec3(0.007f));
     registry->emplace<components::Model3D>(ent, model);
 
+    // Collide against the city itself. Building its tree takes a while, so it's cached next to the asset.
+    auto bvh = plugins::physics::MeshBvh::fromAsset(asset.value(), **pool, "resources/City1.bvh");
+    registry->emplace<components::MeshCollider>(ent, std::make_shared<const plugins::physics::MeshBvh>(std::move(bvh)));
+
     createLightsForEmissiveMaterials(asset.value(), registry);
   }
 
@@ -176,6 +180,8 @@ static std::expected<void, std::string> startup(/* clang-format off */
     registry->emplace<components::Material3D>(skyboxEnt, skyboxMaterial);
   }
 
+  models->box = std::make_shared<model::Cube>(glm::vec3(1.0f));
+
   return {};
 }
 
@@ -183,17 +189,16 @@ static std::expected<void, std::string> update(/* clang-format off */
   std::shared_ptr<entt::registry> registry,
   std::shared_ptr<Renderer> renderer,
   std::shared_ptr<scenes::nfs::resources::CameraState> cameraState,
-  resources::Time& time
+  std::shared_ptr<scenes::nfs::resources::Models> models,
+  const resources::Time& time
 ) { /* clang-format on */
 
   if (input::Mouse::wasJustPressed(input::MouseButton::Left)) {
-    auto boxAsset = std::make_shared<model::Cube>(glm::vec3(1.0f));
-
     // Create the box entity
     auto boxEntity = registry->create();
     registry->emplace<components::Position>(boxEntity, glm::vec3(0.0f, 0.0f, 20.0f));
     // registry->emplace<components::Scale>(boxEntity, glm::vec3(0.03f));
-    registry->emplace<components::Model3D>(boxEntity, boxAsset);
+    registry->emplace<components::Model3D>(boxEntity, models->box);
     registry->emplace<components::Velocity>(boxEntity, glm::vec3(0.0f, 0.0f, 0.0f));
     registry->emplace<components::Acceleration>(boxEntity, constants::WORLD_GRAVITY);
     registry->emplace<components::BoxCollider>(boxEntity, glm::vec3(0.5f));
@@ -370,7 +375,8 @@ static std::expected<void, std::string> update(/* clang-format off */
 void scenes::nfs::NFS::build(Game& game) {
   auto cameraState = std::make_shared<scenes::nfs::resources::CameraState>();
   game.addResource(cameraState);
+  game.addResource(std::make_shared<scenes::nfs::resources::Models>());
 
   game.addSystem(Schedule::Startup, startup);
-  game.addSystem(Schedule::Update, update);
+  game.addSystem(Schedule::Update, "nfs::update", update);
 }
@@ -28,6 +28,11 @@ namespace scenes::nfs {
       float targetYaw = 0.0f;    // Target yaw (behind the car)
       float targetPitch = -0.1f; // Target pitch (slightly down)
     };
+
+    // Models shared by every entity spawned with them, so the renderer can draw them as instances
+    struct Models {
+      std::shared_ptr<Model3D> box;
+    };
   };
 
   struct NFS {
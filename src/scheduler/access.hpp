@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace scheduler {
+  // Dense per-type index into the resource table, assigned the first time a type is seen
+  using ResourceId = size_t;
+
+  inline ResourceId nextResourceId() noexcept {
+    static std::atomic<ResourceId> counter = 0;
+    return counter.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  template <typename T> ResourceId resourceId() noexcept {
+    static const ResourceId id = nextResourceId();
+    return id;
+  }
+
+  // Opt-in wrapper to declare read-only access to a resource that would otherwise count as a write (eg. a shared_ptr)
+  template <typename T> class Read {
+  public:
+    explicit Read(const T& resource) : resource(resource) {
+    }
+
+    [[nodiscard]] const T& get() const noexcept {
+      return resource;
+    }
+
+    const T& operator*() const noexcept {
+      return resource;
+    }
+
+    const T* operator->() const noexcept {
+      return &resource;
+    }
+
+  private:
+    const T& resource;
+  };
+
+  // Opt-in wrapper to declare write access explicitly
+  template <typename T> class Write {
+  public:
+    explicit Write(T& resource) : resource(resource) {
+    }
+
+    [[nodiscard]] T& get() const noexcept {
+      return resource;
+    }
+
+    T& operator*() const noexcept {
+      return resource;
+    }
+
+    T* operator->() const noexcept {
+      return &resource;
+    }
+
+  private:
+    T& resource;
+  };
+
+  template <typename T> struct IsSharedPtr : std::false_type {};
+  template <typename T> struct IsSharedPtr<std::shared_ptr<T>> : std::true_type {};
+
+  // Resources bound to the thread owning the GLFW window / GL context.
+  // Specialize to true for such a resource so any system touching it is kept on the main thread.
+  template <typename T> struct IsMainThreadResource : std::false_type {};
+
+  // Access a resource makes through handles of its own, which its systems' parameters don't show.
+  // Specialize with the system parameters it amounts to (eg. std::tuple<Read<std::shared_ptr<entt::registry>>>) and every
+  // system taking the resource is given that access as well.
+  template <typename T> struct ImpliedAccess {
+    using Params = std::tuple<>;
+  };
+
+  // How a system parameter maps onto a resource:
+  // - const T& and T (copy) are reads
+  // - T& and std::shared_ptr<T> (in any form, as the pointee is mutable) are writes
+  // - Read<T> / Write<T> override the above
+  template <typename Param, typename Decayed = std::remove_cvref_t<Param>> struct SystemParam {
+    using Resource = Decayed;
+
+    static constexpr bool isWrite = /* clang-format off */
+      IsSharedPtr<Decayed>::value ||
+      (std::is_lvalue_reference_v<Param> && !std::is_const_v<std::remove_reference_t<Param>>); /* clang-format on */
+
+    static Resource& fetch(Resource& resource) noexcept {
+      return resource;
+    }
+  };
+
+  template <typename Param, typename T> struct SystemParam<Param, Read<T>> {
+    using Resource = T;
+    static constexpr bool isWrite = false;
+
+    static Read<T> fetch(T& resource) noexcept {
+      return Read<T>(resource);
+    }
+  };
+
+  template <typename Param, typename T> struct SystemParam<Param, Write<T>> {
+    using Resource = T;
+    static constexpr bool isWrite = true;
+
+    static Write<T> fetch(T& resource) noexcept {
+      return Write<T>(resource);
+    }
+  };
+
+  struct Access {
+    std::vector<ResourceId> reads;
+    std::vector<ResourceId> writes;
+
+    // Must run on the main thread (GL / GLFW)
+    bool isMainThread = false;
+
+    // Conflicts with every other system, used when nothing is declared (eg. systems touching global state)
+    bool isExclusive = false;
+  };
+
+  template <typename Param> void addParamAccess(Access& access);
+
+  template <typename... Params> void addImpliedAccess(Access& access, std::type_identity<std::tuple<Params...>>) {
+    (addParamAccess<Params>(access), ...);
+  }
+
+  template <typename Param> void addParamAccess(Access& access) {
+    using Traits = SystemParam<Param>;
+
+    auto id = resourceId<typename Traits::Resource>();
+    if constexpr (Traits::isWrite) {
+      access.writes.push_back(id);
+    } else {
+      access.reads.push_back(id);
+    }
+
+    if constexpr (IsMainThreadResource<typename Traits::Resource>::value) {
+      access.isMainThread = true;
+    }
+
+    addImpliedAccess(access, std::type_identity<typename ImpliedAccess<typename Traits::Resource>::Params>{});
+  }
+
+  template <typename... Params> Access accessOf() {
+    Access access;
+    (addParamAccess<Params>(access), ...);
+
+    // A system without parameters can only be reaching for global state, so don't let it overlap with anything.
+    if constexpr (sizeof...(Params) == 0) {
+      access.isExclusive = true;
+      access.isMainThread = true;
+    }
+
+    return access;
+  }
+}
@@ -0,0 +1,164 @@
+#include "graph.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+
+struct scheduler::Graph::RunState {
+  util::ThreadPool& pool;
+  scheduler::Profiler& profiler;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  std::vector<size_t> remainingDependencies;
+  std::deque<size_t> mainThreadReady;
+  size_t finishedCount = 0;
+
+  // First error wins, every system after that is skipped
+  std::optional<std::string> error;
+};
+
+static bool overlaps(const std::vector<scheduler::ResourceId>& a, const std::vector<scheduler::ResourceId>& b) {
+  return std::ranges::any_of(a, [&b](auto id) { return std::ranges::find(b, id) != b.end(); });
+}
+
+static bool conflicts(const scheduler::Access& a, const scheduler::Access& b) {
+  if (a.isExclusive || b.isExclusive) {
+    return true;
+  }
+
+  return overlaps(a.writes, b.writes) || overlaps(a.writes, b.reads) || overlaps(a.reads, b.writes);
+}
+
+static std::expected<void, std::string> invoke(const scheduler::System& system, scheduler::Profiler& profiler) {
+  auto begin = scheduler::Clock::now();
+
+  std::expected<void, std::string> result;
+  try {
+    result = system.run();
+  } catch (const std::exception& e) {
+    result = std::unexpected(std::string(e.what()));
+  }
+
+  profiler.record(system.profileScope, begin, scheduler::Clock::now());
+
+  return result;
+}
+
+void scheduler::Graph::addSystem(System system) {
+  systems.push_back(std::move(system));
+  isDirty = true;
+}
+
+void scheduler::Graph::rebuild() {
+  dependents.assign(systems.size(), {});
+  dependencyCounts.assign(systems.size(), 0);
+  roots.clear();
+
+  // Earlier registrations win, so conflicting systems keep the order they were added in
+  for (size_t i = 0; i < systems.size(); ++i) {
+    for (size_t j = 0; j < i; ++j) {
+      if (conflicts(systems[j].access, systems[i].access)) {
+        dependents[j].push_back(i);
+        dependencyCounts[i]++;
+      }
+    }
+
+    if (dependencyCounts[i] == 0) {
+      roots.push_back(i);
+    }
+  }
+
+  isDirty = false;
+}
+
+// Expects state->mutex to be held
+void scheduler::Graph::dispatch(const std::shared_ptr<RunState>& state, size_t systemIdx) {
+  if (systems[systemIdx].access.isMainThread) {
+    state->mainThreadReady.push_back(systemIdx);
+    state->changed.notify_all();
+    return;
+  }
+
+  state->pool.submit([this, state, systemIdx]() { execute(state, systemIdx); });
+}
+
+void scheduler::Graph::execute(const std::shared_ptr<RunState>& state, size_t systemIdx) {
+  bool shouldRun;
+  {
+    std::lock_guard lock(state->mutex);
+    shouldRun = !state->error.has_value();
+  }
+
+  if (shouldRun) {
+    auto result = invoke(systems[systemIdx], state->profiler);
+    if (!result) {
+      std::lock_guard lock(state->mutex);
+      if (!state->error.has_value()) {
+        state->error = result.error();
+      }
+    }
+  }
+
+  std::lock_guard lock(state->mutex);
+  state->finishedCount++;
+
+  for (size_t dependent : dependents[systemIdx]) {
+    if (--state->remainingDependencies[dependent] == 0) {
+      dispatch(state, dependent);
+    }
+  }
+
+  state->changed.notify_all();
+}
+
+std::expected<void, std::string> scheduler::Graph::run(util::ThreadPool& pool, Profiler& profiler) {
+  if (isDirty) {
+    rebuild();
+  }
+
+  // Nothing to overlap with, skip the bookkeeping
+  if (systems.size() <= 1 || pool.getWorkerCount() == 0) {
+    for (const auto& system : systems) {
+      auto result = invoke(system, profiler);
+      if (!result) {
+        return std::unexpected(result.error());
+      }
+    }
+
+    return {};
+  }
+
+  auto state = std::make_shared<RunState>(pool, profiler);
+  state->remainingDependencies = dependencyCounts;
+
+  std::unique_lock lock(state->mutex);
+  for (size_t root : roots) {
+    dispatch(state, root);
+  }
+
+  // The main thread works through main-thread systems while the pool handles the rest
+  while (state->finishedCount < systems.size()) {
+    if (state->mainThreadReady.empty()) {
+      state->changed.wait(lock);
+      continue;
+    }
+
+    size_t systemIdx = state->mainThreadReady.front();
+    state->mainThreadReady.pop_front();
+
+    lock.unlock();
+    execute(state, systemIdx);
+    lock.lock();
+  }
+
+  if (state->error.has_value()) {
+    return std::unexpected(state->error.value());
+  }
+
+  return {};
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <expected>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "scheduler/access.hpp"
+#include "scheduler/profiler.hpp"
+#include "util/thread-pool.hpp"
+
+namespace scheduler {
+  struct System {
+    std::function<std::expected<void, std::string>()> run;
+    Access access;
+    size_t profileScope;
+  };
+
+  // Systems of a single schedule, ordered by registration wherever their access conflicts.
+  // Anything that doesn't conflict is free to run concurrently on the thread pool.
+  class Graph {
+  public:
+    void addSystem(System system);
+
+    [[nodiscard]] std::expected<void, std::string> run(util::ThreadPool& pool, Profiler& profiler);
+
+  private:
+    struct RunState;
+
+    void rebuild();
+    void dispatch(const std::shared_ptr<RunState>& state, size_t systemIdx);
+    void execute(const std::shared_ptr<RunState>& state, size_t systemIdx);
+
+    std::vector<System> systems;
+
+    // Per system: systems that must wait on it, and how many systems it waits on
+    std::vector<std::vector<size_t>> dependents;
+    std::vector<size_t> dependencyCounts;
+    std::vector<size_t> roots;
+
+    bool isDirty = false;
+  };
+}
@@ -0,0 +1,283 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <print>
+
+void scheduler::RollingStats::add(float milliseconds) noexcept {
+  samples[nextSample] = milliseconds;
+  nextSample = (nextSample + 1) % WINDOW_SIZE;
+  sampleCount = std::min(sampleCount + 1, WINDOW_SIZE);
+}
+
+float scheduler::RollingStats::getMin() const noexcept {
+  if (sampleCount == 0) {
+    return 0.0f;
+  }
+
+  return *std::min_element(samples.begin(), samples.begin() + sampleCount);
+}
+
+float scheduler::RollingStats::getAverage() const noexcept {
+  if (sampleCount == 0) {
+    return 0.0f;
+  }
+
+  float total = 0.0f;
+  for (size_t i = 0; i < sampleCount; ++i) {
+    total += samples[i];
+  }
+
+  return total / static_cast<float>(sampleCount);
+}
+
+float scheduler::RollingStats::getP99() const {
+  if (sampleCount == 0) {
+    return 0.0f;
+  }
+
+  std::vector<float> sorted(samples.begin(), samples.begin() + sampleCount);
+  size_t rank = std::min(sampleCount - 1, (sampleCount * 99) / 100);
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+
+  return sorted[rank];
+}
+
+size_t scheduler::RollingStats::getSampleCount() const noexcept {
+  return sampleCount;
+}
+
+// Small stable index per thread, used as the trace's tid
+static uint32_t currentThreadIdx() {
+  static std::atomic<uint32_t> nextThreadIdx = 0;
+  thread_local uint32_t threadIdx = nextThreadIdx.fetch_add(1, std::memory_order_relaxed);
+  return threadIdx;
+}
+
+static std::string escapeJson(const std::string& str) {
+  std::string result;
+  result.reserve(str.size());
+
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      result += "\\\"";
+      break;
+    case '\\':
+      result += "\\\\";
+      break;
+    case '\n':
+      result += "\\n";
+      break;
+    case '\r':
+      result += "\\r";
+      break;
+    case '\t':
+      result += "\\t";
+      break;
+    default:
+      // Any other control character has to be escaped too, or the file won't parse
+      if (static_cast<unsigned char>(c) < 0x20) {
+        result += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+      } else {
+        result += c;
+      }
+    }
+  }
+
+  return result;
+}
+
+std::string scheduler::formatReport(std::span<const ProfileScope* const> scopes) {
+  std::string result = std::format("{:<10} {:>10} {:>10} {:>10}  {}\n", "category", "min (ms)", "avg (ms)", "p99 (ms)", "name");
+
+  for (const auto* scope : scopes) {
+    if (scope->stats.getSampleCount() == 0) {
+      continue;
+    }
+
+    result += std::format(/* clang-format off */
+      "{:<10} {:>10.3f} {:>10.3f} {:>10.3f}  {}\n",
+      scope->category,
+      scope->stats.getMin(),
+      scope->stats.getAverage(),
+      scope->stats.getP99(),
+      scope->name
+    ); /* clang-format on */
+  }
+
+  return result;
+}
+
+// Quoted whenever it holds something CSV would split on
+static std::string escapeCsv(const std::string& str) {
+  if (str.find_first_of(",\"\n") == std::string::npos) {
+    return str;
+  }
+
+  std::string result = "\"";
+  for (char c : str) {
+    if (c == '"') {
+      result += '"';
+    }
+    result += c;
+  }
+
+  return result + '"';
+}
+
+std::expected<void, std::string> scheduler::writeStats(const std::filesystem::path& path,
+                                                       std::span<const ProfileScope* const> scopes) {
+  std::ofstream file(path);
+  if (!file) {
+    return std::unexpected(std::format("Failed to open stats file {}", path.string()));
+  }
+
+  std::vector<const ProfileScope*> sampledScopes;
+  std::copy_if(scopes.begin(), scopes.end(), std::back_inserter(sampledScopes), [](const ProfileScope* scope) {
+    return scope->stats.getSampleCount() > 0;
+  });
+
+  bool isJson = path.extension() == ".json";
+  file << (isJson ? "{\"scopes\":[\n" : "category,name,samples,min_ms,avg_ms,p99_ms\n");
+
+  for (size_t i = 0; i < sampledScopes.size(); ++i) {
+    const auto& scope = *sampledScopes[i];
+
+    if (isJson) {
+      file << std::format(/* clang-format off */
+        "{{\"category\":\"{}\",\"name\":\"{}\",\"samples\":{},\"minMs\":{:.4f},\"avgMs\":{:.4f},\"p99Ms\":{:.4f}}}{}\n",
+        escapeJson(scope.category),
+        escapeJson(scope.name),
+        scope.stats.getSampleCount(),
+        scope.stats.getMin(),
+        scope.stats.getAverage(),
+        scope.stats.getP99(),
+        i + 1 < sampledScopes.size() ? "," : ""
+      ); /* clang-format on */
+    } else {
+      file << std::format(/* clang-format off */
+        "{},{},{},{:.4f},{:.4f},{:.4f}\n",
+        escapeCsv(scope.category),
+        escapeCsv(scope.name),
+        scope.stats.getSampleCount(),
+        scope.stats.getMin(),
+        scope.stats.getAverage(),
+        scope.stats.getP99()
+      ); /* clang-format on */
+    }
+  }
+
+  if (isJson) {
+    file << "]}\n";
+  }
+
+  return {};
+}
+
+scheduler::Profiler::Profiler() : epoch(Clock::now()), frameBegin(epoch) {
+  frameScope = addScope("Frame", "frame");
+
+  if (const char* path = std::getenv("QUN_TRACE")) {
+    uint32_t frameCount = 120;
+    if (const char* frames = std::getenv("QUN_TRACE_FRAMES")) {
+      frameCount = static_cast<uint32_t>(std::strtoul(frames, nullptr, 10));
+    }
+
+    captureTrace(path, frameCount);
+  }
+}
+
+size_t scheduler::Profiler::addScope(std::string name, std::string category) {
+  scopes.push_back({.name = std::move(name), .category = std::move(category), .stats = {}});
+  return scopes.size() - 1;
+}
+
+void scheduler::Profiler::record(size_t scopeIdx, Clock::time_point begin, Clock::time_point end) {
+  scopes[scopeIdx].stats.add(std::chrono::duration<float, std::milli>(end - begin).count());
+
+  if (isCapturing.load(std::memory_order_relaxed)) {
+    std::lock_guard lock(traceMutex);
+    traceEvents.push_back({.scopeIdx = scopeIdx, .begin = begin, .end = end, .threadIdx = currentThreadIdx()});
+  }
+}
+
+void scheduler::Profiler::beginFrame() {
+  frameBegin = Clock::now();
+}
+
+void scheduler::Profiler::endFrame() {
+  auto now = Clock::now();
+  record(frameScope, frameBegin, now);
+  frameBegin = now;
+
+  if (isCapturing.load(std::memory_order_relaxed) && --traceFramesLeft == 0) {
+    isCapturing = false;
+    writeTrace();
+  }
+}
+
+void scheduler::Profiler::captureTrace(std::filesystem::path path, uint32_t frameCount) {
+  if (frameCount == 0) {
+    return;
+  }
+
+  std::lock_guard lock(traceMutex);
+  traceEvents.clear();
+  tracePath = std::move(path);
+  traceFramesLeft = frameCount;
+  isCapturing = true;
+}
+
+const scheduler::ProfileScope& scheduler::Profiler::getScope(size_t scopeIdx) const {
+  return scopes[scopeIdx];
+}
+
+size_t scheduler::Profiler::getScopeCount() const noexcept {
+  return scopes.size();
+}
+
+std::string scheduler::Profiler::report() const {
+  std::vector<const ProfileScope*> scopePtrs;
+  scopePtrs.reserve(scopes.size());
+  for (const auto& scope : scopes) {
+    scopePtrs.push_back(&scope);
+  }
+
+  return formatReport(scopePtrs);
+}
+
+void scheduler::Profiler::writeTrace() {
+  std::lock_guard lock(traceMutex);
+
+  std::ofstream file(tracePath);
+  if (!file) {
+    std::println(stderr, "Failed to open trace file {}", tracePath.string());
+    return;
+  }
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+  for (size_t i = 0; i < traceEvents.size(); ++i) {
+    const auto& event = traceEvents[i];
+    const auto& scope = scopes[event.scopeIdx];
+
+    file << std::format(/* clang-format off */
+      "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}{}\n",
+      escapeJson(scope.name),
+      scope.category,
+      std::chrono::duration<double, std::micro>(event.begin - epoch).count(),
+      std::chrono::duration<double, std::micro>(event.end - event.begin).count(),
+      event.threadIdx,
+      i + 1 < traceEvents.size() ? "," : ""
+    ); /* clang-format on */
+  }
+
+  file << "]}\n";
+
+  std::println("Wrote trace of {} events to {}", traceEvents.size(), tracePath.string());
+  traceEvents.clear();
+}
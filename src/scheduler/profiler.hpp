@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace scheduler {
+  using Clock = std::chrono::steady_clock;
+
+  // Window of the most recent durations, in milliseconds
+  class RollingStats {
+  public:
+    static constexpr size_t WINDOW_SIZE = 240;
+
+    void add(float milliseconds) noexcept;
+
+    [[nodiscard]] float getMin() const noexcept;
+    [[nodiscard]] float getAverage() const noexcept;
+    [[nodiscard]] float getP99() const;
+    [[nodiscard]] size_t getSampleCount() const noexcept;
+
+  private:
+    std::array<float, WINDOW_SIZE> samples{};
+    size_t sampleCount = 0;
+    size_t nextSample = 0;
+  };
+
+  struct ProfileScope {
+    std::string name;
+    std::string category;
+    RollingStats stats;
+  };
+
+  // Table of min / avg / p99 for every scope that has samples
+  [[nodiscard]] std::string formatReport(std::span<const ProfileScope* const> scopes);
+
+  // Same as formatReport, as JSON if path ends in .json and as CSV otherwise, for benchmark runs to keep
+  std::expected<void, std::string> writeStats(const std::filesystem::path& path,
+                                              std::span<const ProfileScope* const> scopes);
+
+  // Times systems, schedules and frames, and optionally records them as a Chrome trace
+  // (chrome://tracing or https://ui.perfetto.dev).
+  //
+  // Set QUN_TRACE to a path to capture the first QUN_TRACE_FRAMES (default 120) frames on startup.
+  class Profiler {
+  public:
+    Profiler();
+
+    // Scopes must be added before anything is recorded, they can't be added while schedules are running.
+    size_t addScope(std::string name, std::string category);
+
+    // Safe to call from any thread, as long as a scope is only recorded by one thread at a time
+    void record(size_t scopeIdx, Clock::time_point begin, Clock::time_point end);
+
+    void beginFrame();
+    void endFrame();
+
+    // Starts recording the next frameCount frames, written to path once done
+    void captureTrace(std::filesystem::path path, uint32_t frameCount);
+
+    [[nodiscard]] const ProfileScope& getScope(size_t scopeIdx) const;
+    [[nodiscard]] size_t getScopeCount() const noexcept;
+
+    // Table of min / avg / p99 for every scope that has samples
+    [[nodiscard]] std::string report() const;
+
+  private:
+    struct TraceEvent {
+      size_t scopeIdx;
+      Clock::time_point begin;
+      Clock::time_point end;
+      uint32_t threadIdx;
+    };
+
+    void writeTrace();
+
+    std::deque<ProfileScope> scopes;
+
+    Clock::time_point epoch;
+    Clock::time_point frameBegin;
+    size_t frameScope;
+
+    std::mutex traceMutex;
+    std::vector<TraceEvent> traceEvents;
+    std::filesystem::path tracePath;
+    uint32_t traceFramesLeft = 0;
+    std::atomic<bool> isCapturing = false;
+  };
+}
@@ -0,0 +1,26 @@
+#include "cpu.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+  #include <immintrin.h>
+  #include <intrin.h>
+#endif
+
+bool util::cpu::hasAvx2() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+  int info[4];
+  __cpuid(info, 1);
+
+  // OSXSAVE and AVX, then the OS has to actually save the ymm registers
+  bool hasAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+  if (!hasAvx) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return info[1] & (1 << 5);
+#elif defined(__x86_64__)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
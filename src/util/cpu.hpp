@@ -0,0 +1,16 @@
+#pragma once
+
+// Compiles a function for AVX2 regardless of the global flags, so it must only be called once hasAvx2 says so. MSVC
+// allows AVX2 intrinsics anywhere and needs nothing.
+#if defined(__x86_64__) || defined(_M_X64)
+  #if defined(_MSC_VER) && !defined(__clang__)
+    #define QUN_TARGET_AVX2
+  #else
+    #define QUN_TARGET_AVX2 __attribute__((target("avx2")))
+  #endif
+#endif
+
+namespace util::cpu {
+  // Whether both the CPU and the OS support AVX2, for picking a kernel at runtime. Always false off x86-64.
+  [[nodiscard]] bool hasAvx2() noexcept;
+}
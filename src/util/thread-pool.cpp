@@ -0,0 +1,121 @@
+#include "thread-pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+
+util::ThreadPool::ThreadPool(size_t workerCount) {
+  workers.reserve(workerCount);
+  for (size_t i = 0; i < workerCount; ++i) {
+    workers.emplace_back([this]() { workerLoop(); });
+  }
+}
+
+util::ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard lock(tasksMutex);
+    isStopping = true;
+  }
+
+  tasksAvailable.notify_all();
+  workers.clear(); // jthread joins on destruction
+}
+
+void util::ThreadPool::submit(std::function<void()> task) {
+  if (workers.empty()) {
+    task();
+    return;
+  }
+
+  {
+    std::lock_guard lock(tasksMutex);
+    tasks.push(std::move(task));
+  }
+
+  tasksAvailable.notify_one();
+}
+
+void util::ThreadPool::parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn) {
+  if (count == 0) {
+    return;
+  }
+
+  chunkSize = std::max<size_t>(chunkSize, 1);
+  size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+  if (chunkCount == 1 || workers.empty()) {
+    fn(0, count);
+    return;
+  }
+
+  // Helpers may only get scheduled after every chunk is already done, so the shared state must outlive this call.
+  struct State {
+    std::atomic<size_t> nextChunk = 0;
+    std::atomic<size_t> doneChunks = 0;
+    std::mutex mutex;
+    std::condition_variable allDone;
+  };
+
+  auto state = std::make_shared<State>();
+
+  auto work = [state, count, chunkSize, chunkCount, &fn]() {
+    while (true) {
+      size_t chunk = state->nextChunk.fetch_add(1, std::memory_order_relaxed);
+      if (chunk >= chunkCount) {
+        return;
+      }
+
+      size_t begin = chunk * chunkSize;
+      fn(begin, std::min(begin + chunkSize, count));
+
+      if (state->doneChunks.fetch_add(1, std::memory_order_acq_rel) + 1 == chunkCount) {
+        std::lock_guard lock(state->mutex);
+        state->allDone.notify_all();
+      }
+    }
+  };
+
+  size_t helperCount = std::min(workers.size(), chunkCount - 1);
+  for (size_t i = 0; i < helperCount; ++i) {
+    submit(work);
+  }
+
+  work();
+
+  std::unique_lock lock(state->mutex);
+  state->allDone.wait(lock, [&state, chunkCount]() { return state->doneChunks.load(std::memory_order_acquire) == chunkCount; });
+}
+
+size_t util::ThreadPool::getWorkerCount() const noexcept {
+  return workers.size();
+}
+
+size_t util::ThreadPool::defaultWorkerCount() noexcept {
+  if (const char* env = std::getenv("QUN_WORKER_THREADS")) {
+    return static_cast<size_t>(std::strtoul(env, nullptr, 10));
+  }
+
+  size_t hardwareThreads = std::thread::hardware_concurrency();
+  return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void util::ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> task;
+
+    {
+      std::unique_lock lock(tasksMutex);
+      tasksAvailable.wait(lock, [this]() { return isStopping || !tasks.empty(); });
+
+      if (isStopping && tasks.empty()) {
+        return;
+      }
+
+      task = std::move(tasks.front());
+      tasks.pop();
+    }
+
+    task();
+  }
+}
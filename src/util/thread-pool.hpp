@@ -0,0 +1,41 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace util {
+  // Fixed set of worker threads shared by the scheduler and any subsystem that wants to fan work out.
+  class ThreadPool final {
+  public:
+    explicit ThreadPool(size_t workerCount = defaultWorkerCount());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Splits [0, count) into chunks of chunkSize and runs fn(begin, end) on each.
+    // The calling thread takes part, so this is safe to call from inside a pool task.
+    void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& fn);
+
+    [[nodiscard]] size_t getWorkerCount() const noexcept;
+
+    // Hardware threads minus the main thread, overridable with QUN_WORKER_THREADS
+    [[nodiscard]] static size_t defaultWorkerCount() noexcept;
+
+  private:
+    void workerLoop();
+
+    std::vector<std::jthread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex tasksMutex;
+    std::condition_variable tasksAvailable;
+    bool isStopping = false;
+  };
+}
@@ -0,0 +1,215 @@
+#include "trs.hpp"
+#include "cpu.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+  #define QUN_TRS_X86
+  #include <immintrin.h>
+#endif
+
+void util::trs::Batch::resize(size_t count) {
+  positionX.resize(count);
+  positionY.resize(count);
+  positionZ.resize(count);
+
+  rotationX.resize(count);
+  rotationY.resize(count);
+  rotationZ.resize(count);
+  rotationW.resize(count);
+
+  scaleX.resize(count);
+  scaleY.resize(count);
+  scaleZ.resize(count);
+}
+
+void util::trs::Batch::set(size_t idx, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale) {
+  positionX[idx] = position.x;
+  positionY[idx] = position.y;
+  positionZ[idx] = position.z;
+
+  rotationX[idx] = rotation.x;
+  rotationY[idx] = rotation.y;
+  rotationZ[idx] = rotation.z;
+  rotationW[idx] = rotation.w;
+
+  scaleX[idx] = scale.x;
+  scaleY[idx] = scale.y;
+  scaleZ[idx] = scale.z;
+}
+
+size_t util::trs::Batch::size() const noexcept {
+  return positionX.size();
+}
+
+static void composeScalar(const util::trs::Batch& batch, glm::mat4* out, size_t begin, size_t end) {
+  for (size_t i = begin; i < end; ++i) {
+    float x = batch.rotationX[i], y = batch.rotationY[i], z = batch.rotationZ[i], w = batch.rotationW[i];
+    float sx = batch.scaleX[i], sy = batch.scaleY[i], sz = batch.scaleZ[i];
+
+    float xx = x * x, yy = y * y, zz = z * z;
+    float xy = x * y, xz = x * z, yz = y * z;
+    float wx = w * x, wy = w * y, wz = w * z;
+
+    glm::mat4& m = out[i];
+    m[0] = {(1.0f - 2.0f * (yy + zz)) * sx, 2.0f * (xy + wz) * sx, 2.0f * (xz - wy) * sx, 0.0f};
+    m[1] = {2.0f * (xy - wz) * sy, (1.0f - 2.0f * (xx + zz)) * sy, 2.0f * (yz + wx) * sy, 0.0f};
+    m[2] = {2.0f * (xz + wy) * sz, 2.0f * (yz - wx) * sz, (1.0f - 2.0f * (xx + yy)) * sz, 0.0f};
+    m[3] = {batch.positionX[i], batch.positionY[i], batch.positionZ[i], 1.0f};
+  }
+}
+
+#ifdef QUN_TRS_X86
+// Transposes one column of 4 matrices out of rows-of-lanes form and stores it
+static inline void storeColumn(float* out, size_t column, __m128 row0, __m128 row1, __m128 row2, __m128 row3) {
+  _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+  _mm_storeu_ps(out + 0 * 16 + column * 4, row0);
+  _mm_storeu_ps(out + 1 * 16 + column * 4, row1);
+  _mm_storeu_ps(out + 2 * 16 + column * 4, row2);
+  _mm_storeu_ps(out + 3 * 16 + column * 4, row3);
+}
+
+static void composeSse(const util::trs::Batch& batch, glm::mat4* out, size_t count) {
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 zero = _mm_setzero_ps();
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m128 x = _mm_loadu_ps(&batch.rotationX[i]), y = _mm_loadu_ps(&batch.rotationY[i]);
+    __m128 z = _mm_loadu_ps(&batch.rotationZ[i]), w = _mm_loadu_ps(&batch.rotationW[i]);
+    __m128 sx = _mm_loadu_ps(&batch.scaleX[i]), sy = _mm_loadu_ps(&batch.scaleY[i]), sz = _mm_loadu_ps(&batch.scaleZ[i]);
+
+    __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+    __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+    __m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+
+    float* dst = reinterpret_cast<float*>(out + i);
+
+    /* clang-format off */
+    storeColumn(dst, 0,
+      _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+      _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx),
+      _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+      zero
+    );
+    storeColumn(dst, 1,
+      _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+      _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+      _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy),
+      zero
+    );
+    storeColumn(dst, 2,
+      _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+      _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+      _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz),
+      zero
+    );
+    storeColumn(dst, 3,
+      _mm_loadu_ps(&batch.positionX[i]),
+      _mm_loadu_ps(&batch.positionY[i]),
+      _mm_loadu_ps(&batch.positionZ[i]),
+      one
+    );
+    /* clang-format on */
+  }
+
+  composeScalar(batch, out, i, count);
+}
+
+// Same as storeColumn, for 8 matrices at once
+QUN_TARGET_AVX2 static inline void storeColumn8(float* out, size_t column, __m256 row0, __m256 row1, __m256 row2, __m256 row3) {
+  storeColumn(out, column, /* clang-format off */
+    _mm256_castps256_ps128(row0),
+    _mm256_castps256_ps128(row1),
+    _mm256_castps256_ps128(row2),
+    _mm256_castps256_ps128(row3)
+  ); /* clang-format on */
+
+  storeColumn(out + 4 * 16, column, /* clang-format off */
+    _mm256_extractf128_ps(row0, 1),
+    _mm256_extractf128_ps(row1, 1),
+    _mm256_extractf128_ps(row2, 1),
+    _mm256_extractf128_ps(row3, 1)
+  ); /* clang-format on */
+}
+
+QUN_TARGET_AVX2 static void composeAvx2(const util::trs::Batch& batch, glm::mat4* out, size_t count) {
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 zero = _mm256_setzero_ps();
+
+  size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(&batch.rotationX[i]), y = _mm256_loadu_ps(&batch.rotationY[i]);
+    __m256 z = _mm256_loadu_ps(&batch.rotationZ[i]), w = _mm256_loadu_ps(&batch.rotationW[i]);
+    __m256 sx = _mm256_loadu_ps(&batch.scaleX[i]), sy = _mm256_loadu_ps(&batch.scaleY[i]);
+    __m256 sz = _mm256_loadu_ps(&batch.scaleZ[i]);
+
+    __m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+    __m256 xy = _mm256_mul_ps(x, y), xz = _mm256_mul_ps(x, z), yz = _mm256_mul_ps(y, z);
+    __m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+
+    float* dst = reinterpret_cast<float*>(out + i);
+
+    /* clang-format off */
+    storeColumn8(dst, 0,
+      _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), sx),
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx),
+      zero
+    );
+    storeColumn8(dst, 1,
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+      _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), sy),
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy),
+      zero
+    );
+    storeColumn8(dst, 2,
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+      _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+      _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), sz),
+      zero
+    );
+    storeColumn8(dst, 3,
+      _mm256_loadu_ps(&batch.positionX[i]),
+      _mm256_loadu_ps(&batch.positionY[i]),
+      _mm256_loadu_ps(&batch.positionZ[i]),
+      one
+    );
+    /* clang-format on */
+  }
+
+  composeScalar(batch, out, i, count);
+}
+#endif
+
+using ComposeKernel = void (*)(const util::trs::Batch&, glm::mat4*, size_t);
+
+struct SelectedKernel {
+  ComposeKernel fn;
+  const char* name;
+};
+
+static const SelectedKernel& selectedKernel() {
+  static const SelectedKernel kernel = []() -> SelectedKernel {
+#ifdef QUN_TRS_X86
+    if (util::cpu::hasAvx2()) {
+      return {composeAvx2, "avx2"};
+    }
+
+    return {composeSse, "sse"};
+#else
+    return {[](const util::trs::Batch& batch, glm::mat4* out, size_t count) { composeScalar(batch, out, 0, count); }, "scalar"};
+#endif
+  }();
+
+  return kernel;
+}
+
+void util::trs::compose(const Batch& batch, glm::mat4* out) {
+  selectedKernel().fn(batch, out, batch.size());
+}
+
+const char* util::trs::getKernelName() noexcept {
+  return selectedKernel().name;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+namespace util::trs {
+  // Position / rotation / scale of many entities in structure-of-arrays form, so they can be loaded a vector at a time
+  struct Batch {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+    std::vector<float> scaleX, scaleY, scaleZ;
+
+    // Sized once per batch, then every entry filled in with set
+    void resize(size_t count);
+    void set(size_t idx, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+
+    [[nodiscard]] size_t size() const noexcept;
+  };
+
+  // Writes translate * rotate * scale for every entry of batch into out, which must hold batch.size() matrices.
+  // Rotations are expected to be normalized, same as glm::mat4_cast.
+  //
+  // Runs 8 entries at a time with AVX2 or 4 with SSE, whichever the CPU supports, and scalar code elsewhere.
+  void compose(const Batch& batch, glm::mat4* out);
+
+  // Name of the kernel compose picked for this CPU
+  [[nodiscard]] const char* getKernelName() noexcept;
+}
@@ -0,0 +1,21 @@
+#include "type.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#include <cstdlib>
+#include <cxxabi.h>
+#include <memory>
+#endif
+
+std::string util::type::demangle(const char* name) {
+#if defined(__GNUC__) || defined(__clang__)
+  int status = 0;
+  std::unique_ptr<char, decltype(&std::free)> demangled(abi::__cxa_demangle(name, nullptr, nullptr, &status), &std::free);
+
+  if (status == 0 && demangled) {
+    return std::string(demangled.get());
+  }
+#endif
+
+  // MSVC names are already readable
+  return std::string(name);
+}
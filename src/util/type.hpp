@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <typeinfo>
+
+namespace util::type {
+  // Human readable name of a type, as reported by typeid
+  std::string demangle(const char* name);
+
+  template <typename T> std::string nameOf() {
+    return demangle(typeid(T).name());
+  }
+}